@@ -3,9 +3,9 @@
 #include <string.h>
 #include <gmp.h>
 #include "src/sign/gost3410.h"
+#include "src/sign/gost_curve.h"
 #include "src/ec/ec_point.h"
 #include "src/hash/types.h"
-#include "src/hash/stribog.h"
 
 // Test parameters from the task
 #define D_STR "7A929ADE789BB9BE10ED359DD39A72C11B60961F49397EEE1D19CE9891EC3B28"
@@ -13,41 +13,32 @@
 #define QX_STR "7F2B49E270DB6D90D8595BEC458B50C58585BA1D4E9B788F6689DBD8E56FD80B"
 #define QY_STR "26F1B489D6701DD185C8413A977B3CBBAF64D1C593D26627DFFB101A87FF77DA"
 
-// Curve parameters from GOST R 34.10-2012 (example)
-#define P_STR "8000000000000000000000000000000000000000000000000000000000000431"
-#define A_STR "7"
-#define Q_STR "8000000000000000000000000000000150FE8A1892976154C59CFC193ACCF5B3"
-#define PX_STR "2"
-#define PY_STR "8E2A8A0E65147D4BD6316030E16D19C85C97F0A9CA267122B96ABBCEA7E8FC8"
+// Curve parameters from GOST R 34.10-2012 (example), taken from the built-in registry
+#define CURVE_NAME "id-GostR3410-2001-TestParamSet"
 
 // Block size for Stribog
 #define BLOCK_SIZE 64
+// The message is read and hashed in chunks of this size
+#define CHUNK_SIZE (1024 * BLOCK_SIZE)
 
-/* Function to read the contents of a file into a buffer */
-unsigned char* read_file(const char *filename, size_t *out_size) {
+/* Function to open the message file for reading in chunks */
+FILE* open_file(const char *filename) {
     FILE *fp = fopen(filename, "rb");
     if (!fp) {
         perror("Error opening file");
         exit(EXIT_FAILURE);
     }
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    rewind(fp);
-    unsigned char *buffer = (unsigned char*)malloc(size);
-    if (!buffer) {
-        fclose(fp);
-        fprintf(stderr, "Memory allocation error\n");
-        exit(EXIT_FAILURE);
-    }
-    if (fread(buffer, 1, size, fp) != (size_t)size) {
+    return fp;
+}
+
+/* Function to check that the whole file was read */
+void check_read(FILE *fp) {
+    if (ferror(fp)) {
         fclose(fp);
-        free(buffer);
         fprintf(stderr, "Error reading file\n");
         exit(EXIT_FAILURE);
     }
     fclose(fp);
-    *out_size = size;
-    return buffer;
 }
 
 /* Function to write the signature to a file sig.txt (r and s in hexadecimal format, each on a separate line) */
@@ -96,19 +87,12 @@ void read_signature(mpz_t r, mpz_t s, const char *filename) {
 
 /* Main program */
 int main() {
-    // Initialize curve parameters
-    mpz_t p, a, q;
-    mpz_inits(p, a, q, NULL);
-    mpz_set_str(p, P_STR, 16);
-    mpz_set_str(a, A_STR, 16);
-    mpz_set_str(q, Q_STR, 16);
-
-    // Base point P
-    EC_Point P;
-    ec_point_init(&P);
-    mpz_set_str(P.x, PX_STR, 16);
-    mpz_set_str(P.y, PY_STR, 16);
-    P.infinity = 0;
+    // Curve context: parameters, base point P and precomputed tables
+    const gost_curve_t *curve = gost_curve_get(CURVE_NAME);
+    if (!curve) {
+        fprintf(stderr, "Unknown curve %s\n", CURVE_NAME);
+        exit(EXIT_FAILURE);
+    }
 
     // Private key d
     mpz_t d;
@@ -117,7 +101,7 @@ int main() {
     // Calculate public key Q = d * P (coordinates are printed for debugging purposes)
     EC_Point Q_calc;
     ec_point_init(&Q_calc);
-    ec_point_mul(&Q_calc, d, &P, p, a);
+    ec_point_mul_table_ct(&Q_calc, d, &curve->T);
     gmp_printf("Calculated coordinates of Q:\nQ.x = %Zx\nQ.y = %Zx\n\n", Q_calc.x, Q_calc.y);
 
     // For verification, use the known public key value
@@ -141,48 +125,59 @@ int main() {
     while ((c = getchar()) != '\n' && c != EOF);
 
     if (choice == 1) {
-        // Read the message from file
-        size_t msg_len;
-        unsigned char *msg = read_file("file.txt", &msg_len);
-        printf("=== DEBUG: Read file.txt, size = %zu bytes ===\n", msg_len);
-        
         mpz_t r, s;
         mpz_inits(r, s, NULL);
 
-        printf("=== DEBUG: Calling gost3410_sign ===\n");
-        gost3410_sign(r, s, msg, msg_len, d, q, p, a, &P);
+        // Hash the message from file chunk by chunk while signing
+        printf("=== DEBUG: Calling gost3410_sign (streaming) ===\n");
+        gost3410_sign_ctx_t ctx;
+        unsigned char buf[CHUNK_SIZE];
+        size_t n, msg_len = 0;
+        FILE *fp = open_file("file.txt");
+        gost3410_sign_init(&ctx, d, curve);
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+            gost3410_sign_update(&ctx, buf, n);
+            msg_len += n;
+        }
+        check_read(fp);
+        gost3410_sign_final(&ctx, r, s);
+        printf("=== DEBUG: Read file.txt, size = %zu bytes ===\n", msg_len);
         gmp_printf("Signature:\nr = %Zx\ns = %Zx\n", r, s);
         
         // Save the signature to file
         write_signature(r, s, "sig.txt");
         printf("Signature saved to sig.txt\n");
         
-        free(msg);
         mpz_clears(r, s, NULL);
     } else if (choice == 2) {
-        // Read the message from file
-        size_t msg_len;
-        unsigned char *msg = read_file("file.txt", &msg_len);
-        printf("=== DEBUG: Read file.txt, size = %zu bytes ===\n", msg_len);
-        
         mpz_t r, s;
         mpz_inits(r, s, NULL);
         read_signature(r, s, "sig.txt");
         gmp_printf("Read signature:\nr = %Zx\ns = %Zx\n", r, s);
         
-        printf("=== DEBUG: Calling gost3410_verify ===\n");
-        int valid = gost3410_verify(msg, msg_len, r, s, &Q, q, p, a, &P);
+        // Hash the message from file chunk by chunk while verifying
+        printf("=== DEBUG: Calling gost3410_verify (streaming) ===\n");
+        gost3410_verify_ctx_t ctx;
+        unsigned char buf[CHUNK_SIZE];
+        size_t n, msg_len = 0;
+        FILE *fp = open_file("file.txt");
+        gost3410_verify_init(&ctx, &Q, curve);
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+            gost3410_verify_update(&ctx, buf, n);
+            msg_len += n;
+        }
+        check_read(fp);
+        printf("=== DEBUG: Read file.txt, size = %zu bytes ===\n", msg_len);
+        int valid = gost3410_verify_final(&ctx, r, s);
         printf("Signature is %s\n", valid ? "VALID" : "INVALID");
         
-        free(msg);
         mpz_clears(r, s, NULL);
     } else {
         printf("Invalid choice\n");
     }
 
     // Clean up resources
-    mpz_clears(p, a, q, d, NULL);
-    ec_point_clear(&P);
+    mpz_clear(d);
     ec_point_clear(&Q);
     ec_point_clear(&Q_calc);
     
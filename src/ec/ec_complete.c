@@ -0,0 +1,190 @@
+#include "ec_complete.h"
+
+/* r = a*t; для a = -3 вместо умножения три сложения */
+static void ec_mul_a(const ec_ctx_t *E, fp_t *r, const fp_t *t) {
+    if (E->a_is_m3) {
+        fp_t t3;
+        fp_add(&E->F, &t3, t, t);
+        fp_add(&E->F, &t3, &t3, t);
+        fp_neg(&E->F, r, &t3);
+    } else {
+        fp_mul(&E->F, r, &E->a, t);
+    }
+}
+
+void ec_ctx_set_b(ec_ctx_t *E, const ec_apoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t t, u;
+
+    fp_sqr(F, &t, &P->x);
+    fp_add(F, &t, &t, &E->a);
+    fp_mul(F, &t, &t, &P->x);                 // x^3 + a*x
+    fp_sqr(F, &u, &P->y);
+    fp_sub(F, &t, &u, &t);                    // b
+    fp_add(F, &u, &t, &t);
+    fp_add(F, &E->b3, &u, &t);
+    E->has_b = 1;
+}
+
+void ec_ppoint_set_infinity(const ec_ctx_t *E, ec_ppoint_t *R) {
+    fp_set_ui(&E->F, &R->X, 0);
+    fp_set_ui(&E->F, &R->Y, 1);
+    fp_set_ui(&E->F, &R->Z, 0);
+}
+
+void ec_ppoint_from_apoint(const ec_ctx_t *E, ec_ppoint_t *R, const ec_apoint_t *P) {
+    if (P->infinity) {
+        ec_ppoint_set_infinity(E, R);
+        return;
+    }
+    fp_copy(&E->F, &R->X, &P->x);
+    fp_copy(&E->F, &R->Y, &P->y);
+    fp_set_ui(&E->F, &R->Z, 1);
+}
+
+void ec_ppoint_to_jpoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_ppoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t zz;
+
+    fp_sqr(F, &zz, &P->Z);
+    fp_mul(F, &R->X, &P->X, &P->Z);
+    fp_mul(F, &R->Y, &P->Y, &zz);
+    fp_copy(F, &R->Z, &P->Z);
+}
+
+void ec_ppoint_add(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, const ec_ppoint_t *Q) {
+    const fp_ctx_t *F = &E->F;
+    fp_t t0, t1, t2, t3, t4, t5, X3, Y3, Z3;
+
+    fp_mul(F, &t0, &P->X, &Q->X);
+    fp_mul(F, &t1, &P->Y, &Q->Y);
+    fp_mul(F, &t2, &P->Z, &Q->Z);
+    fp_add(F, &t3, &P->X, &P->Y);
+    fp_add(F, &t4, &Q->X, &Q->Y);
+    fp_mul(F, &t3, &t3, &t4);
+    fp_add(F, &t4, &t0, &t1);
+    fp_sub(F, &t3, &t3, &t4);                 // X1*Y2 + X2*Y1
+    fp_add(F, &t4, &P->X, &P->Z);
+    fp_add(F, &t5, &Q->X, &Q->Z);
+    fp_mul(F, &t4, &t4, &t5);
+    fp_add(F, &t5, &t0, &t2);
+    fp_sub(F, &t4, &t4, &t5);                 // X1*Z2 + X2*Z1
+    fp_add(F, &t5, &P->Y, &P->Z);
+    fp_add(F, &X3, &Q->Y, &Q->Z);
+    fp_mul(F, &t5, &t5, &X3);
+    fp_add(F, &X3, &t1, &t2);
+    fp_sub(F, &t5, &t5, &X3);                 // Y1*Z2 + Y2*Z1
+    ec_mul_a(E, &Z3, &t4);
+    fp_mul(F, &X3, &E->b3, &t2);
+    fp_add(F, &Z3, &X3, &Z3);
+    fp_sub(F, &X3, &t1, &Z3);
+    fp_add(F, &Z3, &t1, &Z3);
+    fp_mul(F, &Y3, &X3, &Z3);
+    fp_add(F, &t1, &t0, &t0);
+    fp_add(F, &t1, &t1, &t0);
+    ec_mul_a(E, &t2, &t2);
+    fp_mul(F, &t4, &E->b3, &t4);
+    fp_add(F, &t1, &t1, &t2);
+    fp_sub(F, &t2, &t0, &t2);
+    ec_mul_a(E, &t2, &t2);
+    fp_add(F, &t4, &t4, &t2);
+    fp_mul(F, &t0, &t1, &t4);
+    fp_add(F, &Y3, &Y3, &t0);
+    fp_mul(F, &t0, &t5, &t4);
+    fp_mul(F, &X3, &t3, &X3);
+    fp_sub(F, &R->X, &X3, &t0);
+    fp_mul(F, &t0, &t3, &t1);
+    fp_mul(F, &Z3, &t5, &Z3);
+    fp_add(F, &R->Z, &Z3, &t0);
+    fp_copy(F, &R->Y, &Y3);
+}
+
+void ec_ppoint_add_affine(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, const ec_apoint_t *Q) {
+    const fp_ctx_t *F = &E->F;
+    fp_t t0, t1, t2, t3, t4, t5, X3, Y3, Z3;
+
+    fp_mul(F, &t0, &P->X, &Q->x);
+    fp_mul(F, &t1, &P->Y, &Q->y);
+    fp_add(F, &t3, &Q->x, &Q->y);
+    fp_add(F, &t4, &P->X, &P->Y);
+    fp_mul(F, &t3, &t3, &t4);
+    fp_add(F, &t4, &t0, &t1);
+    fp_sub(F, &t3, &t3, &t4);                 // X1*y2 + x2*Y1
+    fp_mul(F, &t4, &Q->x, &P->Z);
+    fp_add(F, &t4, &t4, &P->X);               // X1 + x2*Z1
+    fp_mul(F, &t5, &Q->y, &P->Z);
+    fp_add(F, &t5, &t5, &P->Y);               // Y1 + y2*Z1
+    ec_mul_a(E, &Z3, &t4);
+    fp_mul(F, &X3, &E->b3, &P->Z);
+    fp_add(F, &Z3, &X3, &Z3);
+    fp_sub(F, &X3, &t1, &Z3);
+    fp_add(F, &Z3, &t1, &Z3);
+    fp_mul(F, &Y3, &X3, &Z3);
+    fp_add(F, &t1, &t0, &t0);
+    fp_add(F, &t1, &t1, &t0);
+    ec_mul_a(E, &t2, &P->Z);
+    fp_mul(F, &t4, &E->b3, &t4);
+    fp_add(F, &t1, &t1, &t2);
+    fp_sub(F, &t2, &t0, &t2);
+    ec_mul_a(E, &t2, &t2);
+    fp_add(F, &t4, &t4, &t2);
+    fp_mul(F, &t0, &t1, &t4);
+    fp_add(F, &Y3, &Y3, &t0);
+    fp_mul(F, &t0, &t5, &t4);
+    fp_mul(F, &X3, &t3, &X3);
+    fp_sub(F, &R->X, &X3, &t0);
+    fp_mul(F, &t0, &t3, &t1);
+    fp_mul(F, &Z3, &t5, &Z3);
+    fp_add(F, &R->Z, &Z3, &t0);
+    fp_copy(F, &R->Y, &Y3);
+}
+
+void ec_ppoint_dbl(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t t0, t1, t2, t3, X3, Y3, Z3;
+
+    fp_sqr(F, &t0, &P->X);
+    fp_sqr(F, &t1, &P->Y);
+    fp_sqr(F, &t2, &P->Z);
+    fp_mul(F, &t3, &P->X, &P->Y);
+    fp_add(F, &t3, &t3, &t3);
+    fp_mul(F, &Z3, &P->X, &P->Z);
+    fp_add(F, &Z3, &Z3, &Z3);
+    ec_mul_a(E, &X3, &Z3);
+    fp_mul(F, &Y3, &E->b3, &t2);
+    fp_add(F, &Y3, &X3, &Y3);
+    fp_sub(F, &X3, &t1, &Y3);
+    fp_add(F, &Y3, &t1, &Y3);
+    fp_mul(F, &Y3, &X3, &Y3);
+    fp_mul(F, &X3, &t3, &X3);
+    fp_mul(F, &Z3, &E->b3, &Z3);
+    ec_mul_a(E, &t2, &t2);
+    fp_sub(F, &t3, &t0, &t2);
+    ec_mul_a(E, &t3, &t3);
+    fp_add(F, &t3, &t3, &Z3);
+    fp_add(F, &Z3, &t0, &t0);
+    fp_add(F, &t0, &Z3, &t0);
+    fp_add(F, &t0, &t0, &t2);
+    fp_mul(F, &t0, &t0, &t3);
+    fp_add(F, &Y3, &Y3, &t0);
+    fp_mul(F, &t2, &P->Y, &P->Z);
+    fp_add(F, &t2, &t2, &t2);
+    fp_mul(F, &t0, &t2, &t3);
+    fp_sub(F, &R->X, &X3, &t0);
+    fp_mul(F, &Z3, &t2, &t1);
+    fp_add(F, &Z3, &Z3, &Z3);
+    fp_add(F, &R->Z, &Z3, &Z3);
+    fp_copy(F, &R->Y, &Y3);
+}
+
+void ec_ppoint_cnd_copy(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, mp_limb_t cond) {
+    fp_cnd_copy(&E->F, &R->X, &P->X, cond);
+    fp_cnd_copy(&E->F, &R->Y, &P->Y, cond);
+    fp_cnd_copy(&E->F, &R->Z, &P->Z, cond);
+}
+
+void ec_ppoint_select(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *tab, size_t n, size_t idx) {
+    *R = tab[0];
+    for (size_t j = 1; j < n; j++)
+        ec_ppoint_cnd_copy(E, R, &tab[j], ec_ct_eq(j, idx));
+}
@@ -0,0 +1,46 @@
+#ifndef EC_COMPLETE_H
+#define EC_COMPLETE_H
+
+#include <gmp.h>
+#include "ec_point.h"
+
+/* Полные формулы сложения Ренеса — Костелло — Батины (Renes, Costello, Batina,
+   «Complete addition formulas for prime order elliptic curves», 2016) для
+   кривой y^2 = x^3 + a*x + b в однородных проективных координатах.
+   Одна и та же последовательность операций поля верна для любых входов:
+   бесконечности, P == Q, P == -Q. На кривых с кофактором (tc26 paramSetA-256,
+   paramSetC-512) исключения возможны только для пар, разность которых имеет
+   порядок 2, поэтому внутри подгруппы порядка q формулы тоже полные.
+   Формулам нужен 3b: он вычисляется по точке кривой (ec_ctx_set_b). */
+
+/* Точка в проективных координатах: x = X/Z, y = Y/Z; (0 : 1 : 0) — бесконечность */
+typedef struct {
+    fp_t X, Y, Z;
+} ec_ppoint_t;
+
+/* Вычисление коэффициента b = y^2 - x^3 - a*x по точке P кривой (P не бесконечность)
+   и запись 3b в контекст */
+void ec_ctx_set_b(ec_ctx_t *E, const ec_apoint_t *P);
+
+void ec_ppoint_set_infinity(const ec_ctx_t *E, ec_ppoint_t *R);
+void ec_ppoint_from_apoint(const ec_ctx_t *E, ec_ppoint_t *R, const ec_apoint_t *P);
+
+/* Перевод в якобиевы координаты без обращений и ветвлений: (X*Z : Y*Z^2 : Z) */
+void ec_ppoint_to_jpoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_ppoint_t *P);
+
+/* R = P + Q (алгоритм 1 статьи), 12M + 2 умножения на 3b + 3 на a. Допускается совпадение аргументов. */
+void ec_ppoint_add(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, const ec_ppoint_t *Q);
+
+/* R = P + Q для аффинной Q (алгоритм 2), 11M. Q не должна быть бесконечностью. */
+void ec_ppoint_add_affine(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, const ec_apoint_t *Q);
+
+/* R = 2P (алгоритм 3), 8M + 3S. Допускается R == P. */
+void ec_ppoint_dbl(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P);
+
+/* R = P, если cond = 1, иначе R не меняется (без ветвлений) */
+void ec_ppoint_cnd_copy(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *P, mp_limb_t cond);
+
+/* Выбор tab[idx] из n точек с просмотром всей таблицы по маске */
+void ec_ppoint_select(const ec_ctx_t *E, ec_ppoint_t *R, const ec_ppoint_t *tab, size_t n, size_t idx);
+
+#endif // EC_COMPLETE_H
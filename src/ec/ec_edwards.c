@@ -0,0 +1,207 @@
+#include "ec_edwards.h"
+#include <string.h>
+
+/* Известные кривые с формой Эдвардса (рекомендации ТК 26): модуль и коэффициент a
+   формы Вейерштрасса для распознавания, параметры e, d и s = (e-d)/4, t = (e+d)/6 */
+static const struct {
+    const char *p, *a, *e, *d, *s, *t;
+} ec_edwards_curves[] = {
+    {   // id-tc26-gost-3410-2012-256-paramSetA
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+        "C2173F1513981673AF4892C23035A27CE25E2013BF95AA33B22C656F277E7335",
+        "1",
+        "0605F6B7C183FA81578BC39CFAD518132B9DF62897009AF7E522C32D6DC7BFFB",
+        "7E7E82520F9F015FAA1D0F18C14AB9FB35188275DA3FD94206B74F34A48E0ECD",
+        "100FE73F595FF158E974B44D478D9588744FE5C192AC47EA63075DCE7A14AAA"
+    },
+    {   // id-tc26-gost-3410-2012-512-paramSetC
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+        "DC9203E514A721875485A529D2C722FB187BC8980EB866644DE41C68E1430645"
+        "46E861C0E2C9EDD92ADE71F46FCF50FF2AD97F951FDA9F2A2EB6546F39689BD3",
+        "1",
+        "9E4F5D8C017D8D9F13A5CF3CDF5BFE4DAB402D54198E31EBDE28A0621050439C"
+        "A6B39E0A515C06B304E2CE43E79E369E91A0CFC2BC2A22B4CA302DBB33EE7550",
+        "186C289CFFA09C983B168C30C829006C952FF4AAF99C73850875D7E77BEBEF18"
+        "D653187D6BA8FE533EC74C6F061872585B97CC0F50F57752CD73F4913304621E",
+        "9A628F975594ECEFD89BA28A2539FFB79C8AB238AEED0851FA5C1ABB02B80B44"
+        "C6734501B83A011DD625CD0B5145091A6D9ACD4B1F5C5B1E21B2B249DDFD1271"
+    },
+};
+
+void ec_edwards_detect(ec_ctx_t *E, const mpz_t p, const mpz_t a) {
+    mpz_t t;
+
+    E->edwards = 0;
+    // Оба модуля вида 2^k - c: остальные кривые отсекаются без разбора строк
+    if (E->F.red != FP_RED_PM_MINUS)
+        return;
+
+    mpz_init(t);
+    for (size_t i = 0; i < sizeof(ec_edwards_curves) / sizeof(ec_edwards_curves[0]); i++) {
+        mpz_set_str(t, ec_edwards_curves[i].p, 16);
+        if (mpz_cmp(t, p) != 0)
+            continue;
+        mpz_set_str(t, ec_edwards_curves[i].a, 16);
+        if (!mpz_congruent_p(t, a, p))
+            continue;
+
+        mpz_set_str(t, ec_edwards_curves[i].e, 16);
+        E->ed_e_is_one = mpz_cmp_ui(t, 1) == 0;
+        fp_from_mpz(&E->F, &E->ed_e, t);
+        mpz_set_str(t, ec_edwards_curves[i].d, 16);
+        fp_from_mpz(&E->F, &E->ed_d, t);
+        mpz_set_str(t, ec_edwards_curves[i].s, 16);
+        fp_from_mpz(&E->F, &E->ed_s, t);
+        mpz_set_str(t, ec_edwards_curves[i].t, 16);
+        fp_from_mpz(&E->F, &E->ed_t, t);
+        E->edwards = 1;
+        break;
+    }
+    mpz_clear(t);
+}
+
+void ec_epoint_set_neutral(const ec_ctx_t *E, ec_epoint_t *R) {
+    fp_set_ui(&E->F, &R->X, 0);
+    fp_set_ui(&E->F, &R->Y, 1);
+    fp_set_ui(&E->F, &R->T, 0);
+    fp_set_ui(&E->F, &R->Z, 1);
+}
+
+/* u = (x - t)/y, v = (x - t - s)/(x - t + s); в проективной записи с общим
+   знаменателем y*(x - t + s), затем переход к расширенным координатам */
+int ec_epoint_from_apoint(const ec_ctx_t *E, ec_epoint_t *R, const ec_apoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t w, wp, wm, X, Y, Z;
+
+    if (P->infinity) {
+        ec_epoint_set_neutral(E, R);
+        return 0;
+    }
+
+    fp_sub(F, &w, &P->x, &E->ed_t);           // w = x - t
+    fp_add(F, &wp, &w, &E->ed_s);             // w + s
+    fp_sub(F, &wm, &w, &E->ed_s);             // w - s
+    if (fp_is_zero(F, &P->y) || fp_is_zero(F, &wp))
+        return -1;
+
+    fp_mul(F, &X, &w, &wp);
+    fp_mul(F, &Y, &wm, &P->y);
+    fp_mul(F, &Z, &P->y, &wp);
+
+    fp_mul(F, &R->X, &X, &Z);
+    fp_mul(F, &R->Y, &Y, &Z);
+    fp_mul(F, &R->T, &X, &Y);
+    fp_sqr(F, &R->Z, &Z);
+    return 0;
+}
+
+/* Обратное отображение. При D = (Z - Y)*X:
+   x = (s*(Z+Y)*X + t*D) / D,  y = s*(Z+Y)*Z / D,
+   что в якобиевых координатах даёт Zj = D без обращения */
+void ec_epoint_to_jpoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_epoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t d, sy, t0;
+
+    if (fp_is_zero(F, &P->X)) {
+        if (fp_equal(F, &P->Y, &P->Z)) {
+            // Нейтральный элемент (0, 1) — точка на бесконечности
+            ec_jpoint_set_infinity(E, R);
+        } else {
+            // (0, -1) — точка порядка 2 (t, 0)
+            fp_copy(F, &R->X, &E->ed_t);
+            fp_set_ui(F, &R->Y, 0);
+            fp_set_ui(F, &R->Z, 1);
+        }
+        return;
+    }
+
+    fp_sub(F, &d, &P->Z, &P->Y);
+    fp_mul(F, &d, &d, &P->X);                 // D = (Z - Y)*X
+    fp_add(F, &sy, &P->Z, &P->Y);
+    fp_mul(F, &sy, &sy, &E->ed_s);            // s*(Z + Y)
+
+    fp_mul(F, &t0, &sy, &P->X);
+    fp_mul(F, &R->X, &E->ed_t, &d);
+    fp_add(F, &t0, &t0, &R->X);
+    fp_mul(F, &R->X, &t0, &d);                // Xj = (s*(Z+Y)*X + t*D)*D
+
+    fp_sqr(F, &t0, &d);
+    fp_mul(F, &sy, &sy, &P->Z);
+    fp_mul(F, &R->Y, &sy, &t0);               // Yj = s*(Z+Y)*Z*D^2
+    fp_copy(F, &R->Z, &d);                    // Zj = D
+}
+
+void ec_epoint_dbl(const ec_ctx_t *E, ec_epoint_t *R, const ec_epoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t a, b, c, d, e, g, h;
+
+    fp_sqr(F, &a, &P->X);                     // A = X^2
+    fp_sqr(F, &b, &P->Y);                     // B = Y^2
+    fp_sqr(F, &c, &P->Z);
+    fp_add(F, &c, &c, &c);                    // C = 2*Z^2
+    if (E->ed_e_is_one)
+        fp_copy(F, &d, &a);                   // D = e*A
+    else
+        fp_mul(F, &d, &E->ed_e, &a);
+    fp_add(F, &e, &P->X, &P->Y);
+    fp_sqr(F, &e, &e);
+    fp_sub(F, &e, &e, &a);
+    fp_sub(F, &e, &e, &b);                    // E = (X+Y)^2 - A - B
+    fp_add(F, &g, &d, &b);                    // G = D + B
+    fp_sub(F, &a, &g, &c);                    // F = G - C
+    fp_sub(F, &h, &d, &b);                    // H = D - B
+
+    fp_mul(F, &R->X, &e, &a);                 // X3 = E*F
+    fp_mul(F, &R->Y, &g, &h);                 // Y3 = G*H
+    fp_mul(F, &R->T, &e, &h);                 // T3 = E*H
+    fp_mul(F, &R->Z, &a, &g);                 // Z3 = F*G
+}
+
+void ec_epoint_add(const ec_ctx_t *E, ec_epoint_t *R, const ec_epoint_t *P, const ec_epoint_t *Q) {
+    const fp_ctx_t *F = &E->F;
+    fp_t a, b, c, d, e, f, g, h;
+
+    fp_mul(F, &a, &P->X, &Q->X);              // A = X1*X2
+    fp_mul(F, &b, &P->Y, &Q->Y);              // B = Y1*Y2
+    fp_mul(F, &c, &P->T, &Q->T);
+    fp_mul(F, &c, &c, &E->ed_d);              // C = d*T1*T2
+    fp_mul(F, &d, &P->Z, &Q->Z);              // D = Z1*Z2
+    fp_add(F, &e, &P->X, &P->Y);
+    fp_add(F, &f, &Q->X, &Q->Y);
+    fp_mul(F, &e, &e, &f);
+    fp_sub(F, &e, &e, &a);
+    fp_sub(F, &e, &e, &b);                    // E = (X1+Y1)*(X2+Y2) - A - B
+    fp_sub(F, &f, &d, &c);                    // F = D - C
+    fp_add(F, &g, &d, &c);                    // G = D + C
+    if (E->ed_e_is_one) {
+        fp_sub(F, &h, &b, &a);                // H = B - e*A
+    } else {
+        fp_mul(F, &h, &E->ed_e, &a);
+        fp_sub(F, &h, &b, &h);
+    }
+
+    fp_mul(F, &R->X, &e, &f);                 // X3 = E*F
+    fp_mul(F, &R->Y, &g, &h);                 // Y3 = G*H
+    fp_mul(F, &R->T, &e, &h);                 // T3 = E*H
+    fp_mul(F, &R->Z, &f, &g);                 // Z3 = F*G
+}
+
+/* «double and add» слева направо в расширенных координатах */
+int ec_edwards_mul(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P) {
+    ec_epoint_t base, acc;
+
+    if (ec_epoint_from_apoint(E, &base, P) != 0)
+        return -1;
+
+    ec_epoint_set_neutral(E, &acc);
+    if (mpz_sgn(k) > 0) {
+        for (size_t i = mpz_sizeinbase(k, 2); i-- > 0;) {
+            ec_epoint_dbl(E, &acc, &acc);
+            if (mpz_tstbit(k, i))
+                ec_epoint_add(E, &acc, &acc, &base);
+        }
+    }
+    ec_epoint_to_jpoint(E, R, &acc);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef EC_EDWARDS_H
+#define EC_EDWARDS_H
+
+#include <gmp.h>
+#include "ec_point.h"
+
+/* Кривые tc26 id-tc26-gost-3410-2012-256-paramSetA и id-tc26-gost-3410-2012-512-paramSetC
+   заданы в стандарте и в форме Вейерштрасса, и в форме скрученной кривой Эдвардса
+   e*u^2 + v^2 = 1 + d*u^2*v^2. Для них внутренние вычисления ведутся в расширенных
+   координатах Эдвардса, где сложение полное и дешевле формул Вейерштрасса;
+   на границе точки переводятся обратно, результат совпадает побитно. */
+
+/* Точка в расширенных координатах: u = X/Z, v = Y/Z, T = X*Y/Z */
+typedef struct {
+    fp_t X, Y, T, Z;
+} ec_epoint_t;
+
+/* Распознавание кривой по (p, a) и заполнение параметров Эдвардса в E.
+   Вызывается из ec_ctx_init; для остальных кривых E->edwards = 0. */
+void ec_edwards_detect(ec_ctx_t *E, const mpz_t p, const mpz_t a);
+
+/* Перевод аффинной точки Вейерштрасса в форму Эдвардса.
+   Возвращает -1 для точек, не имеющих образа (порядка 2 и им подобных). */
+int ec_epoint_from_apoint(const ec_ctx_t *E, ec_epoint_t *R, const ec_apoint_t *P);
+
+/* Перевод точки Эдвардса в якобиевы координаты Вейерштрасса без обращений */
+void ec_epoint_to_jpoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_epoint_t *P);
+
+void ec_epoint_set_neutral(const ec_ctx_t *E, ec_epoint_t *R);
+
+/* R = 2P (dbl-2008-hwcd). Допускается R == P. */
+void ec_epoint_dbl(const ec_ctx_t *E, ec_epoint_t *R, const ec_epoint_t *P);
+
+/* R = P + Q (add-2008-hwcd), полная формула без особых случаев. Допускается совпадение аргументов. */
+void ec_epoint_add(const ec_ctx_t *E, ec_epoint_t *R, const ec_epoint_t *P, const ec_epoint_t *Q);
+
+/* R = k * P с вычислениями в форме Эдвардса. Возвращает -1, если P не переводится
+   в форму Эдвардса (тогда вызывающий использует формулы Вейерштрасса). */
+int ec_edwards_mul(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P);
+
+#endif // EC_EDWARDS_H
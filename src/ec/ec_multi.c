@@ -0,0 +1,280 @@
+#include "ec_multi.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/* Окно метода Штрауса: таблица кратных 1..8 для каждой точки, знаковые цифры по основанию 16 */
+#define EC_MULTI_STRAUS_W        4
+#define EC_MULTI_STRAUS_ENTRIES  (1 << (EC_MULTI_STRAUS_W - 1))
+/* Предельная ширина окна корзин (2^14 корзин на поток) */
+#define EC_MULTI_MAX_C           15
+
+/* Знаковая запись |k| по основанию 2^c: nwin цифр в [-2^(c-1), 2^(c-1)], цифра окна w
+   записывается в d[w*stride]. Для отрицательного k знаки цифр меняются. */
+static void ec_multi_recode(int *d, size_t stride, const mpz_t k, size_t nwin, int c) {
+    int carry = 0, neg = mpz_sgn(k) < 0;
+
+    for (size_t w = 0; w < nwin; w++) {
+        int v = 0;
+        for (int b = c; b-- > 0;) {
+            size_t bit = w * c + b;
+            v = (v << 1) | (int)((mpz_getlimbn(k, (mp_size_t)(bit / GMP_NUMB_BITS)) >> (bit % GMP_NUMB_BITS)) & 1);
+        }
+        v += carry;
+        carry = v > (1 << (c - 1));
+        if (carry)
+            v -= 1 << c;
+        d[w * stride] = neg ? -v : v;
+    }
+}
+
+/* Прибавление к acc кратного точки, заданного знаковой цифрой d, из строки таблицы row */
+static void ec_multi_add_digit(const ec_ctx_t *E, ec_jpoint_t *acc, const ec_apoint_t *row, int d) {
+    ec_apoint_t neg;
+
+    if (d > 0) {
+        ec_jpoint_add_affine(E, acc, acc, &row[d - 1]);
+    } else if (d < 0) {
+        neg = row[-d - 1];
+        fp_neg(&E->F, &neg.y, &neg.y);
+        ec_jpoint_add_affine(E, acc, acc, &neg);
+    }
+}
+
+/* Метод Штрауса: одна цепочка удвоений на все точки */
+static int ec_multi_straus(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t points[],
+                           mpz_t scalars[], size_t n, size_t bits) {
+    size_t nwin = (bits + EC_MULTI_STRAUS_W - 1) / EC_MULTI_STRAUS_W + 1;
+    ec_jpoint_t *jt = (ec_jpoint_t *)malloc(n * EC_MULTI_STRAUS_ENTRIES * sizeof(ec_jpoint_t));
+    ec_apoint_t *tab = (ec_apoint_t *)malloc(n * EC_MULTI_STRAUS_ENTRIES * sizeof(ec_apoint_t));
+    int *dig = (int *)malloc(n * nwin * sizeof(int));
+    ec_jpoint_t acc;
+
+    if (!jt || !tab || !dig) {
+        free(jt);
+        free(tab);
+        free(dig);
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        ec_jpoint_t *row = jt + i * EC_MULTI_STRAUS_ENTRIES;
+        ec_jpoint_from_apoint(E, &row[0], &points[i]);
+        for (int j = 1; j < EC_MULTI_STRAUS_ENTRIES; j++)
+            ec_jpoint_add_affine(E, &row[j], &row[j - 1], &points[i]);
+        ec_multi_recode(dig + i, n, scalars[i], nwin, EC_MULTI_STRAUS_W);
+    }
+    ec_points_normalize_batch(E, tab, jt, n * EC_MULTI_STRAUS_ENTRIES);
+    free(jt);
+
+    ec_jpoint_set_infinity(E, &acc);
+    for (size_t w = nwin; w-- > 0;) {
+        for (int b = 0; b < EC_MULTI_STRAUS_W; b++)
+            ec_jpoint_dbl(E, &acc, &acc);
+        for (size_t i = 0; i < n; i++)
+            ec_multi_add_digit(E, &acc, tab + i * EC_MULTI_STRAUS_ENTRIES, dig[w * n + i]);
+    }
+    *R = acc;
+
+    free(tab);
+    free(dig);
+    return 0;
+}
+
+/* Окна [wbegin, wend) метода Пиппенджера, обрабатываемые одним потоком */
+typedef struct {
+    const ec_ctx_t *E;
+    const ec_apoint_t *points;
+    const int *dig;             // цифры окна w: dig[w*n + i]
+    size_t n;
+    int c;
+    ec_jpoint_t *sums;          // сумма окна w: sum_j j*B_j
+    size_t wbegin, wend;
+    int status;
+} ec_multi_job_t;
+
+/* Для каждого окна точки раскладываются по корзинам B_1..B_{2^(c-1)} по модулю
+   цифры, затем sum_j j*B_j считается двумя накопительными суммами сверху вниз */
+static void *ec_multi_pippenger_worker(void *arg) {
+    ec_multi_job_t *job = (ec_multi_job_t *)arg;
+    const ec_ctx_t *E = job->E;
+    size_t nb = (size_t)1 << (job->c - 1);
+    ec_jpoint_t *b = (ec_jpoint_t *)malloc(nb * sizeof(ec_jpoint_t));
+    ec_jpoint_t run, sum;
+    ec_apoint_t neg;
+
+    job->status = -1;
+    if (!b)
+        return NULL;
+
+    for (size_t w = job->wbegin; w < job->wend; w++) {
+        const int *dw = job->dig + w * job->n;
+
+        for (size_t j = 0; j < nb; j++)
+            ec_jpoint_set_infinity(E, &b[j]);
+        for (size_t i = 0; i < job->n; i++) {
+            int d = dw[i];
+            if (d > 0) {
+                ec_jpoint_add_affine(E, &b[d - 1], &b[d - 1], &job->points[i]);
+            } else if (d < 0) {
+                neg = job->points[i];
+                fp_neg(&E->F, &neg.y, &neg.y);
+                ec_jpoint_add_affine(E, &b[-d - 1], &b[-d - 1], &neg);
+            }
+        }
+
+        ec_jpoint_set_infinity(E, &run);
+        ec_jpoint_set_infinity(E, &sum);
+        for (size_t j = nb; j-- > 0;) {
+            ec_jpoint_add(E, &run, &run, &b[j]);
+            ec_jpoint_add(E, &sum, &sum, &run);
+        }
+        job->sums[w] = sum;
+    }
+
+    free(b);
+    job->status = 0;
+    return NULL;
+}
+
+/* Метод Пиппенджера с окном c бит; окна делятся между потоками */
+static int ec_multi_pippenger(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t points[],
+                              mpz_t scalars[], size_t n, size_t bits, int c, int nthreads) {
+    size_t nwin = (bits + c - 1) / c + 1, nt, started = 0;
+    int *dig = (int *)malloc(n * nwin * sizeof(int));
+    ec_jpoint_t *sums = (ec_jpoint_t *)malloc(nwin * sizeof(ec_jpoint_t));
+    ec_multi_job_t *jobs;
+    pthread_t *tids;
+    ec_jpoint_t acc;
+    int ret = 0;
+
+    nt = nthreads > 1 ? (size_t)nthreads : 1;
+    if (nt > nwin)
+        nt = nwin;
+    jobs = (ec_multi_job_t *)malloc(nt * sizeof(*jobs));
+    tids = (pthread_t *)malloc(nt * sizeof(*tids));
+    if (!dig || !sums || !jobs || !tids) {
+        ret = -1;
+        goto done;
+    }
+
+    for (size_t i = 0; i < n; i++)
+        ec_multi_recode(dig + i, n, scalars[i], nwin, c);
+
+    for (size_t t = 0; t < nt; t++) {
+        jobs[t].E = E;
+        jobs[t].points = points;
+        jobs[t].dig = dig;
+        jobs[t].n = n;
+        jobs[t].c = c;
+        jobs[t].sums = sums;
+        jobs[t].wbegin = nwin * t / nt;
+        jobs[t].wend = nwin * (t + 1) / nt;
+        jobs[t].status = -1;
+    }
+    for (size_t t = 1; t < nt; t++, started++) {
+        if (pthread_create(&tids[t], NULL, ec_multi_pippenger_worker, &jobs[t]) != 0)
+            break;
+    }
+    ec_multi_pippenger_worker(&jobs[0]);
+    for (size_t t = started + 1; t < nt; t++)
+        ec_multi_pippenger_worker(&jobs[t]);
+    for (size_t t = 1; t <= started; t++)
+        pthread_join(tids[t], NULL);
+    for (size_t t = 0; t < nt; t++)
+        if (jobs[t].status != 0)
+            ret = -1;
+
+    if (ret == 0) {
+        // R = sum_w 2^(c*w) * S_w по схеме Горнера
+        acc = sums[nwin - 1];
+        for (size_t w = nwin - 1; w-- > 0;) {
+            for (int b = 0; b < c; b++)
+                ec_jpoint_dbl(E, &acc, &acc);
+            ec_jpoint_add(E, &acc, &acc, &sums[w]);
+        }
+        *R = acc;
+    }
+
+done:
+    free(dig);
+    free(sums);
+    free(jobs);
+    free(tids);
+    return ret;
+}
+
+/* Оценки числа групповых операций (удвоение считается за одно сложение) */
+static size_t ec_multi_straus_cost(size_t n, size_t bits) {
+    size_t nwin = (bits + EC_MULTI_STRAUS_W - 1) / EC_MULTI_STRAUS_W + 1;
+    return n * (EC_MULTI_STRAUS_ENTRIES + 3) + nwin * (n + EC_MULTI_STRAUS_W);
+}
+
+static size_t ec_multi_pippenger_cost(size_t n, size_t bits, int c) {
+    size_t nwin = (bits + c - 1) / c + 1;
+    return nwin * (n + ((size_t)1 << c) + c);
+}
+
+int ec_multi_mul(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t points[],
+                 mpz_t scalars[], size_t n, int nthreads) {
+    size_t bits = 0, best;
+    int c = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t b = mpz_sizeinbase(scalars[i], 2);
+        if (mpz_sgn(scalars[i]) != 0 && b > bits)
+            bits = b;
+    }
+    if (bits == 0) {
+        ec_jpoint_set_infinity(E, R);
+        return 0;
+    }
+
+    // Одна точка: таблица кратных не окупает своё обращение, обычное умножение
+    // к тому же использует форму Эдвардса там, где она есть
+    if (n == 1) {
+        ec_apoint_t P = points[0];
+        mpz_t k;
+        if (mpz_sgn(scalars[0]) < 0)
+            fp_neg(&E->F, &P.y, &P.y);
+        mpz_roinit_n(k, mpz_limbs_read(scalars[0]), (mp_size_t)mpz_size(scalars[0]));
+        ec_jpoint_mul(E, R, k, &P);
+        return 0;
+    }
+
+    best = ec_multi_straus_cost(n, bits);
+    for (int w = 2; w <= EC_MULTI_MAX_C; w++) {
+        size_t cost = ec_multi_pippenger_cost(n, bits, w);
+        if (cost < best) {
+            best = cost;
+            c = w;
+        }
+    }
+
+    if (c == 0)
+        return ec_multi_straus(E, R, points, scalars, n, bits);
+    return ec_multi_pippenger(E, R, points, scalars, n, bits, c, nthreads);
+}
+
+int ec_point_multi_mul(EC_Point *R, const EC_Point points[], mpz_t scalars[], size_t n,
+                       const mpz_t p, const mpz_t a, int nthreads) {
+    ec_ctx_t E;
+    ec_apoint_t *pts, A;
+    ec_jpoint_t J;
+    int ret;
+
+    if (ec_ctx_init(&E, p, a) != 0)
+        return -1;
+    pts = (ec_apoint_t *)malloc((n ? n : 1) * sizeof(ec_apoint_t));
+    if (!pts)
+        return -1;
+
+    for (size_t i = 0; i < n; i++)
+        ec_apoint_from_point(&E, &pts[i], &points[i]);
+    ret = ec_multi_mul(&E, &J, pts, scalars, n, nthreads);
+    if (ret == 0) {
+        ec_jpoint_to_apoint(&E, &A, &J);
+        ec_apoint_to_point(&E, R, &A);
+    }
+    free(pts);
+    return ret;
+}
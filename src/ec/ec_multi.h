@@ -0,0 +1,23 @@
+#ifndef EC_MULTI_H
+#define EC_MULTI_H
+
+#include <stddef.h>
+#include <gmp.h>
+#include "ec_point.h"
+
+/* Многоскалярное умножение R = k_0*P_0 + ... + k_{n-1}*P_{n-1}.
+   При малых n используется метод Штрауса (общие удвоения, таблица
+   кратных 1..8 каждой точки), при больших — корзины Пиппенджера; метод
+   и ширина окна выбираются по оценке числа сложений. Скаляры могут быть
+   отрицательными. Окна метода Пиппенджера распределяются по nthreads
+   потокам (0 или 1 — всё в вызывающем потоке).
+   Возвращает 0 при успехе, -1 при нехватке памяти. */
+int ec_multi_mul(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t points[],
+                 mpz_t scalars[], size_t n, int nthreads);
+
+/* То же на границе API: точки EC_Point на кривой (p, a), результат в R
+   (R должна быть инициализирована) */
+int ec_point_multi_mul(EC_Point *R, const EC_Point points[], mpz_t scalars[], size_t n,
+                       const mpz_t p, const mpz_t a, int nthreads);
+
+#endif // EC_MULTI_H
@@ -1,152 +1,535 @@
-#include "ec_point.h"
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-
-/* Инициализация точки: выделяются памяти для координат и устанавливается флаг бесконечности */
-void ec_point_init(EC_Point *P) {
-    mpz_init(P->x);
-    mpz_init(P->y);
-    P->infinity = 1; // по умолчанию точка на бесконечности
-}
-
-/* Очистка mpz_t */
-void ec_point_clear(EC_Point *P) {
-    mpz_clear(P->x);
-    mpz_clear(P->y);
-}
-
-/* Копирование точки Q в R */
-void ec_point_copy(EC_Point *R, const EC_Point *Q) {
-    mpz_set(R->x, Q->x);
-    mpz_set(R->y, Q->y);
-    R->infinity = Q->infinity;
-}
-
-/* Функция модульного вычитания: вычисляет rop = a mod m, результат неотрицательный */
-void mod_mpz(mpz_t rop, const mpz_t a, const mpz_t m) {
-    mpz_mod(rop, a, m);
-    if(mpz_sgn(rop) < 0) {
-        mpz_add(rop, rop, m);
-    }
-}
-
-/* Функция сложения точек на эллиптической кривой
-   Параметры:
-     - R – результат (выходная точка)
-     - P, Q – входные точки
-     - p – модуль конечного поля
-     - a – коэффициент кривой
-*/
-void ec_point_add(EC_Point *R, const EC_Point *P, const EC_Point *Q, const mpz_t p, const mpz_t a) {
-    // Если одна из точек на бесконечности, R = другая точка.
-    if(P->infinity) {
-        ec_point_copy(R, Q);
-        return;
-    }
-    if(Q->infinity) {
-        ec_point_copy(R, P);
-        return;
-    }
-    
-    // Если x1 == x2 и (y1 + y2) mod p == 0, то P + Q = O (точка на бесконечности)
-    mpz_t temp;
-    mpz_init(temp);
-    mpz_add(temp, P->y, Q->y);
-    mod_mpz(temp, temp, p);
-    if(mpz_cmp(P->x, Q->x) == 0 && mpz_cmp_ui(temp, 0) == 0) {
-        R->infinity = 1;
-        mpz_clear(temp);
-        return;
-    }
-    
-    mpz_t lambda, numerator, denominator, inv;
-    mpz_inits(lambda, numerator, denominator, inv, NULL);
-    
-    if(mpz_cmp(P->x, Q->x) == 0 && mpz_cmp(P->y, Q->y) == 0) {
-        // Удвоение точки: lambda = (3*x1^2 + a) * (2*y1)^{-1} mod p
-        mpz_mul(numerator, P->x, P->x);       // x1^2
-        mpz_mul_ui(numerator, numerator, 3);    // 3*x1^2
-        mpz_add(numerator, numerator, a);       // 3*x1^2 + a
-        
-        mpz_mul_ui(denominator, P->y, 2);         // 2*y1
-    } else {
-        // Сложение точек: lambda = (y2 - y1) * (x2 - x1)^{-1} mod p
-        mpz_sub(numerator, Q->y, P->y);
-        mpz_sub(denominator, Q->x, P->x);
-    }
-    
-    mod_mpz(numerator, numerator, p);
-    mod_mpz(denominator, denominator, p);
-    
-    // Вычисляем обратный элемент к denominator по модулю p
-    if(mpz_invert(inv, denominator, p) == 0) {
-        // Обратного элемента не существует, ошибка (обычно не происходит, если p – простое)
-        fprintf(stderr, "Error: Inverse element not possible\n");
-        exit(EXIT_FAILURE);
-    }
-    mpz_mul(lambda, numerator, inv);
-    mod_mpz(lambda, lambda, p);
-    
-    // x3 = lambda^2 - x1 - x2 mod p
-    mpz_t x3, y3;
-    mpz_inits(x3, y3, NULL);
-    mpz_mul(x3, lambda, lambda);
-    mpz_sub(x3, x3, P->x);
-    mpz_sub(x3, x3, Q->x);
-    mod_mpz(x3, x3, p);
-    
-    // y3 = lambda*(x1 - x3) - y1 mod p
-    mpz_sub(y3, P->x, x3);
-    mpz_mul(y3, lambda, y3);
-    mpz_sub(y3, y3, P->y);
-    mod_mpz(y3, y3, p);
-    
-    // Записываем результат в R
-    mpz_set(R->x, x3);
-    mpz_set(R->y, y3);
-    R->infinity = 0;
-    
-    mpz_clears(temp, lambda, numerator, denominator, inv, x3, y3, NULL);
-}
-
-/* Скалярное умножение: вычисляем R = k * P методом «двоичного разложения».
-   Параметры:
-     - R – результат (инициализируется внутри)
-     - k – скаляр (mpz_t)
-     - P – исходная точка
-     - p – модуль конечного поля
-     - a – коэффициент кривой (используется при сложении)
-*/
-void ec_point_mul(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a) {
-    // Инициализируем R как точку на бесконечности
-    ec_point_init(R);
-    R->infinity = 1;
-    
-    EC_Point temp, base;
-    ec_point_init(&base);
-    ec_point_copy(&base, P);
-    
-    mpz_t exp;
-    mpz_init_set(exp, k);
-    
-    // Алгоритм «double and add»
-    while(mpz_cmp_ui(exp, 0) > 0) {
-        if(mpz_odd_p(exp)) {
-            EC_Point sum;
-            ec_point_init(&sum);
-            ec_point_add(&sum, R, &base, p, a);
-            ec_point_copy(R, &sum);
-            ec_point_clear(&sum);
-        }
-        EC_Point dbl;
-        ec_point_init(&dbl);
-        ec_point_add(&dbl, &base, &base, p, a);
-        ec_point_copy(&base, &dbl);
-        ec_point_clear(&dbl);
-        mpz_fdiv_q_2exp(exp, exp, 1);  // делим exp на 2
-    }
-    
-    ec_point_clear(&base);
-    mpz_clear(exp);
-}
+#include "ec_point.h"
+#include "ec_edwards.h"
+#include "ec_complete.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Инициализация точки: выделяются памяти для координат и устанавливается флаг бесконечности */
+void ec_point_init(EC_Point *P) {
+    mpz_init(P->x);
+    mpz_init(P->y);
+    P->infinity = 1; // по умолчанию точка на бесконечности
+}
+
+void ec_point_init2(EC_Point *P, mp_bitcnt_t bits) {
+    mpz_init2(P->x, bits);
+    mpz_init2(P->y, bits);
+    P->infinity = 1;
+}
+
+/* Очистка mpz_t */
+void ec_point_clear(EC_Point *P) {
+    mpz_clear(P->x);
+    mpz_clear(P->y);
+}
+
+/* Копирование точки Q в R */
+void ec_point_copy(EC_Point *R, const EC_Point *Q) {
+    mpz_set(R->x, Q->x);
+    mpz_set(R->y, Q->y);
+    R->infinity = Q->infinity;
+}
+
+/* Функция модульного вычитания: вычисляет rop = a mod m, результат неотрицательный */
+void mod_mpz(mpz_t rop, const mpz_t a, const mpz_t m) {
+    mpz_mod(rop, a, m);
+    if(mpz_sgn(rop) < 0) {
+        mpz_add(rop, rop, m);
+    }
+}
+
+/* Инициализация контекста кривой для внутренней арифметики */
+int ec_ctx_init(ec_ctx_t *E, const mpz_t p, const mpz_t a) {
+    fp_t three;
+
+    if (fp_ctx_init(&E->F, p) != 0)
+        return -1;
+    fp_from_mpz(&E->F, &E->a, a);
+
+    // Проверяем, что a = -3 (mod p): тогда удвоение требует меньше умножений
+    fp_set_ui(&E->F, &three, 3);
+    fp_add(&E->F, &three, &three, &E->a);
+    E->a_is_m3 = fp_is_zero(&E->F, &three);
+
+    ec_edwards_detect(E, p, a);
+    E->has_b = 0;
+    return 0;
+}
+
+/* Контекст для функций с «сырыми» параметрами p, a: при неподдерживаемом модуле работа прекращается */
+static void ec_ctx_init_or_die(ec_ctx_t *E, const mpz_t p, const mpz_t a) {
+    if (ec_ctx_init(E, p, a) != 0) {
+        fprintf(stderr, "Error: unsupported field modulus\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ec_apoint_from_point(const ec_ctx_t *E, ec_apoint_t *R, const EC_Point *P) {
+    R->infinity = P->infinity;
+    if (P->infinity) {
+        fp_set_ui(&E->F, &R->x, 0);
+        fp_set_ui(&E->F, &R->y, 0);
+        return;
+    }
+    fp_from_mpz(&E->F, &R->x, P->x);
+    fp_from_mpz(&E->F, &R->y, P->y);
+}
+
+void ec_apoint_to_point(const ec_ctx_t *E, EC_Point *R, const ec_apoint_t *P) {
+    R->infinity = P->infinity;
+    if (P->infinity)
+        return;
+    fp_to_mpz(&E->F, R->x, &P->x);
+    fp_to_mpz(&E->F, R->y, &P->y);
+}
+
+void ec_jpoint_set_infinity(const ec_ctx_t *E, ec_jpoint_t *R) {
+    fp_set_ui(&E->F, &R->X, 1);
+    fp_set_ui(&E->F, &R->Y, 1);
+    fp_set_ui(&E->F, &R->Z, 0);
+}
+
+int ec_jpoint_is_infinity(const ec_ctx_t *E, const ec_jpoint_t *P) {
+    return fp_is_zero(&E->F, &P->Z);
+}
+
+void ec_jpoint_from_apoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t *P) {
+    if (P->infinity) {
+        ec_jpoint_set_infinity(E, R);
+        return;
+    }
+    fp_copy(&E->F, &R->X, &P->x);
+    fp_copy(&E->F, &R->Y, &P->y);
+    fp_set_ui(&E->F, &R->Z, 1);
+}
+
+/* Переход к аффинным координатам: одно обращение Z */
+void ec_jpoint_to_apoint(const ec_ctx_t *E, ec_apoint_t *R, const ec_jpoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t zi, zi2;
+
+    if (ec_jpoint_is_infinity(E, P)) {
+        fp_set_ui(F, &R->x, 0);
+        fp_set_ui(F, &R->y, 0);
+        R->infinity = 1;
+        return;
+    }
+    fp_inv(F, &zi, &P->Z);
+    fp_sqr(F, &zi2, &zi);
+    fp_mul(F, &R->x, &P->X, &zi2);
+    fp_mul(F, &zi2, &zi2, &zi);
+    fp_mul(F, &R->y, &P->Y, &zi2);
+    R->infinity = 0;
+}
+
+/* Приём Монтгомери: c[i] = Z_0*...*Z_i (точки на бесконечности пропускаются),
+   одно обращение c[n-1], затем обратный проход: Z_i^{-1} = c[i-1] * (c[i])^{-1},
+   (c[i-1])^{-1} = Z_i * (c[i])^{-1}. Итого 3(n-1) умножений на все обратные. */
+void ec_points_normalize_batch(const ec_ctx_t *E, ec_apoint_t *R, const ec_jpoint_t *P, size_t n) {
+    const fp_ctx_t *F = &E->F;
+    fp_t *c, inv, zi, zi2;
+    int have = 0;
+
+    if (n == 0)
+        return;
+    c = (fp_t *)malloc(n * sizeof(fp_t));
+    if (!c) {
+        for (size_t i = 0; i < n; i++)
+            ec_jpoint_to_apoint(E, &R[i], &P[i]);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (ec_jpoint_is_infinity(E, &P[i])) {
+            if (have)
+                fp_copy(F, &c[i], &c[i - 1]);
+            else
+                fp_set_ui(F, &c[i], 1);
+        } else {
+            if (have)
+                fp_mul(F, &c[i], &c[i - 1], &P[i].Z);
+            else
+                fp_copy(F, &c[i], &P[i].Z);
+            have = 1;
+        }
+    }
+    fp_inv(F, &inv, &c[n - 1]);
+
+    for (size_t i = n; i-- > 0;) {
+        if (ec_jpoint_is_infinity(E, &P[i])) {
+            fp_set_ui(F, &R[i].x, 0);
+            fp_set_ui(F, &R[i].y, 0);
+            R[i].infinity = 1;
+            continue;
+        }
+        if (i > 0) {
+            fp_mul(F, &zi, &inv, &c[i - 1]);
+            fp_mul(F, &inv, &inv, &P[i].Z);
+        } else {
+            fp_copy(F, &zi, &inv);
+        }
+        fp_sqr(F, &zi2, &zi);
+        fp_mul(F, &R[i].x, &P[i].X, &zi2);
+        fp_mul(F, &zi2, &zi2, &zi);
+        fp_mul(F, &R[i].y, &P[i].Y, &zi2);
+        R[i].infinity = 0;
+    }
+    free(c);
+}
+
+/* Удвоение в якобиевых координатах (dbl-2007-bl, для a = -3 — dbl-2001-b).
+   Для точки на бесконечности и точки порядка 2 формулы дают Z3 = 0. */
+void ec_jpoint_dbl(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P) {
+    const fp_ctx_t *F = &E->F;
+    fp_t t0, t1, t2, t3;
+
+    if (E->a_is_m3) {
+        fp_sqr(F, &t0, &P->Z);                // delta = Z^2
+        fp_sqr(F, &t1, &P->Y);                // gamma = Y^2
+        fp_mul(F, &t2, &P->X, &t1);           // beta = X*gamma
+        fp_sub(F, &t3, &P->X, &t0);
+        fp_add(F, &R->X, &P->X, &t0);
+        fp_mul(F, &t3, &t3, &R->X);
+        fp_add(F, &R->X, &t3, &t3);
+        fp_add(F, &t3, &R->X, &t3);           // alpha = 3*(X-delta)*(X+delta)
+        fp_add(F, &R->Z, &P->Y, &P->Z);
+        fp_sqr(F, &R->Z, &R->Z);
+        fp_sub(F, &R->Z, &R->Z, &t1);
+        fp_sub(F, &R->Z, &R->Z, &t0);         // Z3 = (Y+Z)^2 - gamma - delta
+        fp_add(F, &t2, &t2, &t2);
+        fp_add(F, &t2, &t2, &t2);             // 4*beta
+        fp_sqr(F, &R->X, &t3);
+        fp_sub(F, &R->X, &R->X, &t2);
+        fp_sub(F, &R->X, &R->X, &t2);         // X3 = alpha^2 - 8*beta
+        fp_sub(F, &t2, &t2, &R->X);
+        fp_mul(F, &t2, &t3, &t2);
+        fp_sqr(F, &t1, &t1);
+        fp_add(F, &t1, &t1, &t1);
+        fp_add(F, &t1, &t1, &t1);
+        fp_add(F, &t1, &t1, &t1);
+        fp_sub(F, &R->Y, &t2, &t1);           // Y3 = alpha*(4*beta - X3) - 8*gamma^2
+        return;
+    }
+
+    fp_t xx, yy, zz;
+    fp_sqr(F, &xx, &P->X);                    // XX = X^2
+    fp_sqr(F, &yy, &P->Y);                    // YY = Y^2
+    fp_sqr(F, &zz, &P->Z);                    // ZZ = Z^2
+    fp_sqr(F, &t0, &yy);                      // YYYY = YY^2
+    fp_add(F, &t1, &P->X, &yy);
+    fp_sqr(F, &t1, &t1);
+    fp_sub(F, &t1, &t1, &xx);
+    fp_sub(F, &t1, &t1, &t0);
+    fp_add(F, &t1, &t1, &t1);                 // S = 2*((X+YY)^2 - XX - YYYY)
+    fp_sqr(F, &t2, &zz);
+    fp_mul(F, &t2, &t2, &E->a);
+    fp_add(F, &t3, &xx, &xx);
+    fp_add(F, &t3, &t3, &xx);
+    fp_add(F, &t3, &t3, &t2);                 // M = 3*XX + a*ZZ^2
+    fp_add(F, &R->Z, &P->Y, &P->Z);
+    fp_sqr(F, &R->Z, &R->Z);
+    fp_sub(F, &R->Z, &R->Z, &yy);
+    fp_sub(F, &R->Z, &R->Z, &zz);             // Z3 = (Y+Z)^2 - YY - ZZ
+    fp_sqr(F, &R->X, &t3);
+    fp_sub(F, &R->X, &R->X, &t1);
+    fp_sub(F, &R->X, &R->X, &t1);             // X3 = M^2 - 2*S
+    fp_sub(F, &t1, &t1, &R->X);
+    fp_mul(F, &t1, &t3, &t1);
+    fp_add(F, &t0, &t0, &t0);
+    fp_add(F, &t0, &t0, &t0);
+    fp_add(F, &t0, &t0, &t0);
+    fp_sub(F, &R->Y, &t1, &t0);               // Y3 = M*(S - X3) - 8*YYYY
+}
+
+/* Сложение в якобиевых координатах (add-2007-bl) с обработкой особых случаев */
+void ec_jpoint_add(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P, const ec_jpoint_t *Q) {
+    const fp_ctx_t *F = &E->F;
+    fp_t z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v;
+
+    if (ec_jpoint_is_infinity(E, P)) {
+        *R = *Q;
+        return;
+    }
+    if (ec_jpoint_is_infinity(E, Q)) {
+        *R = *P;
+        return;
+    }
+
+    fp_sqr(F, &z1z1, &P->Z);
+    fp_sqr(F, &z2z2, &Q->Z);
+    fp_mul(F, &u1, &P->X, &z2z2);
+    fp_mul(F, &u2, &Q->X, &z1z1);
+    fp_mul(F, &s1, &P->Y, &Q->Z);
+    fp_mul(F, &s1, &s1, &z2z2);
+    fp_mul(F, &s2, &Q->Y, &P->Z);
+    fp_mul(F, &s2, &s2, &z1z1);
+    fp_sub(F, &h, &u2, &u1);
+    fp_sub(F, &rr, &s2, &s1);
+
+    if (fp_is_zero(F, &h)) {
+        // Одинаковые x: либо удвоение, либо P == -Q
+        if (fp_is_zero(F, &rr))
+            ec_jpoint_dbl(E, R, P);
+        else
+            ec_jpoint_set_infinity(E, R);
+        return;
+    }
+
+    fp_add(F, &i, &h, &h);
+    fp_sqr(F, &i, &i);                        // I = (2H)^2
+    fp_mul(F, &j, &h, &i);                    // J = H*I
+    fp_add(F, &rr, &rr, &rr);                 // r = 2*(S2 - S1)
+    fp_mul(F, &v, &u1, &i);                   // V = U1*I
+
+    fp_add(F, &u2, &P->Z, &Q->Z);
+    fp_sqr(F, &u2, &u2);
+    fp_sub(F, &u2, &u2, &z1z1);
+    fp_sub(F, &u2, &u2, &z2z2);
+    fp_mul(F, &R->Z, &u2, &h);                // Z3 = ((Z1+Z2)^2 - Z1Z1 - Z2Z2)*H
+
+    fp_sqr(F, &R->X, &rr);
+    fp_sub(F, &R->X, &R->X, &j);
+    fp_sub(F, &R->X, &R->X, &v);
+    fp_sub(F, &R->X, &R->X, &v);              // X3 = r^2 - J - 2V
+
+    fp_sub(F, &v, &v, &R->X);
+    fp_mul(F, &v, &rr, &v);
+    fp_mul(F, &s1, &s1, &j);
+    fp_add(F, &s1, &s1, &s1);
+    fp_sub(F, &R->Y, &v, &s1);                // Y3 = r*(V - X3) - 2*S1*J
+}
+
+/* Смешанное сложение: P в якобиевых координатах, Q — аффинная (madd-2007-bl) */
+void ec_jpoint_add_affine(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P, const ec_apoint_t *Q) {
+    const fp_ctx_t *F = &E->F;
+    fp_t z1z1, u2, s2, h, hh, i, j, rr, v;
+
+    if (Q->infinity) {
+        *R = *P;
+        return;
+    }
+    if (ec_jpoint_is_infinity(E, P)) {
+        ec_jpoint_from_apoint(E, R, Q);
+        return;
+    }
+
+    fp_sqr(F, &z1z1, &P->Z);
+    fp_mul(F, &u2, &Q->x, &z1z1);             // U2 = X2*Z1Z1
+    fp_mul(F, &s2, &Q->y, &P->Z);
+    fp_mul(F, &s2, &s2, &z1z1);               // S2 = Y2*Z1*Z1Z1
+    fp_sub(F, &h, &u2, &P->X);                // H = U2 - X1
+    fp_sub(F, &rr, &s2, &P->Y);
+
+    if (fp_is_zero(F, &h)) {
+        if (fp_is_zero(F, &rr))
+            ec_jpoint_dbl(E, R, P);
+        else
+            ec_jpoint_set_infinity(E, R);
+        return;
+    }
+
+    fp_sqr(F, &hh, &h);                       // HH = H^2
+    fp_add(F, &i, &hh, &hh);
+    fp_add(F, &i, &i, &i);                    // I = 4*HH
+    fp_mul(F, &j, &h, &i);                    // J = H*I
+    fp_add(F, &rr, &rr, &rr);                 // r = 2*(S2 - Y1)
+    fp_mul(F, &v, &P->X, &i);                 // V = X1*I
+
+    fp_add(F, &R->Z, &P->Z, &h);
+    fp_sqr(F, &R->Z, &R->Z);
+    fp_sub(F, &R->Z, &R->Z, &z1z1);
+    fp_sub(F, &R->Z, &R->Z, &hh);             // Z3 = (Z1+H)^2 - Z1Z1 - HH
+
+    fp_mul(F, &s2, &P->Y, &j);                // Y1*J (до перезаписи R, если R == P)
+
+    fp_sqr(F, &R->X, &rr);
+    fp_sub(F, &R->X, &R->X, &j);
+    fp_sub(F, &R->X, &R->X, &v);
+    fp_sub(F, &R->X, &R->X, &v);              // X3 = r^2 - J - 2V
+
+    fp_sub(F, &v, &v, &R->X);
+    fp_mul(F, &v, &rr, &v);
+    fp_add(F, &s2, &s2, &s2);
+    fp_sub(F, &R->Y, &v, &s2);                // Y3 = r*(V - X3) - 2*Y1*J
+}
+
+/* Скалярное умножение «double and add» слева направо со смешанным сложением */
+void ec_jpoint_mul(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P) {
+    ec_jpoint_t acc;
+
+    // Для кривых tc26 с формой Эдвардса считаем в ней
+    if (E->edwards && ec_edwards_mul(E, R, k, P) == 0)
+        return;
+
+    ec_jpoint_set_infinity(E, &acc);
+
+    if (mpz_sgn(k) > 0 && !P->infinity) {
+        for (size_t i = mpz_sizeinbase(k, 2); i-- > 0;) {
+            ec_jpoint_dbl(E, &acc, &acc);
+            if (mpz_tstbit(k, i))
+                ec_jpoint_add_affine(E, &acc, &acc, P);
+        }
+    }
+    *R = acc;
+}
+
+mp_limb_t ec_scalar_recode_regular(signed char *d, const mpz_t k, size_t ndig) {
+    mp_limb_t kl[(4 * EC_CT_MAX_DIGITS) / GMP_NUMB_BITS + 2] = {0}, k0;
+    size_t size = mpz_size(k);
+
+    mpn_copyi(kl, mpz_limbs_read(k), (mp_size_t)size);
+    k0 = kl[0] & 1;
+    kl[0] |= 1;
+
+    // k_{i+1} = (k_i >> 4) | 1, d_i = (k_i mod 32) - 16
+    for (size_t i = 0; i + 1 < ndig; i++) {
+        size_t pos = 4 * i, off = pos % GMP_NUMB_BITS;
+        mp_limb_t u = kl[pos / GMP_NUMB_BITS] >> off;
+        if (off > GMP_NUMB_BITS - 5)
+            u |= kl[pos / GMP_NUMB_BITS + 1] << (GMP_NUMB_BITS - off);
+        d[i] = (signed char)((int)((u & 31) | 1) - 16);
+    }
+    d[ndig - 1] = 1;
+    return k0;
+}
+
+size_t ec_digit_index(signed char d) {
+    int v = d;
+    int neg = -(int)ec_digit_sign(d);
+    return (size_t)(((v ^ neg) - neg - 1) >> 1);
+}
+
+mp_limb_t ec_digit_sign(signed char d) {
+    return (mp_limb_t)((unsigned)(int)d >> (sizeof(unsigned) * 8 - 1));
+}
+
+mp_limb_t ec_ct_eq(size_t i, size_t j) {
+    mp_limb_t x = (mp_limb_t)(i ^ j);
+    return ((x | ((mp_limb_t)0 - x)) >> (GMP_NUMB_BITS - 1)) ^ 1;
+}
+
+void ec_apoint_select(const ec_ctx_t *E, ec_apoint_t *R, const ec_apoint_t *tab, size_t n, size_t idx) {
+    *R = tab[0];
+    for (size_t j = 1; j < n; j++) {
+        mp_limb_t eq = ec_ct_eq(j, idx);
+        fp_cnd_copy(&E->F, &R->x, &tab[j].x, eq);
+        fp_cnd_copy(&E->F, &R->y, &tab[j].y, eq);
+    }
+}
+
+/* Окно 4 бита, 8 нечётных кратных в проективных координатах; сложения по полным
+   формулам, так что особых случаев (совпадение аккумулятора со слагаемым) нет */
+void ec_jpoint_mul_ct(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P, size_t bits) {
+    ec_ctx_t C = *E;
+    ec_ppoint_t tab[8], P2, acc, t;
+    ec_apoint_t negP;
+    signed char d[EC_CT_MAX_DIGITS];
+    size_t nd = (bits + 3) / 4 + 1;
+    mp_limb_t odd;
+
+    if (P->infinity || mpz_sgn(k) < 0 || mpz_sizeinbase(k, 2) > bits || nd > EC_CT_MAX_DIGITS) {
+        ec_jpoint_mul(E, R, k, P);
+        return;
+    }
+    C.F.ct = 1;
+    if (!C.has_b)
+        ec_ctx_set_b(&C, P);
+    odd = ec_scalar_recode_regular(d, k, nd);
+
+    ec_ppoint_from_apoint(&C, &tab[0], P);
+    ec_ppoint_dbl(&C, &P2, &tab[0]);
+    for (int j = 1; j < 8; j++)
+        ec_ppoint_add(&C, &tab[j], &tab[j - 1], &P2);   // (2j+1)*P
+
+    acc = tab[0];                                       // старшая цифра равна 1
+    for (size_t i = nd - 1; i-- > 0;) {
+        for (int b = 0; b < 4; b++)
+            ec_ppoint_dbl(&C, &acc, &acc);
+        ec_ppoint_select(&C, &t, tab, 8, ec_digit_index(d[i]));
+        fp_cnd_neg(&C.F, &t.Y, &t.Y, ec_digit_sign(d[i]));
+        ec_ppoint_add(&C, &acc, &acc, &t);
+    }
+
+    // Для чётного k посчитано (k+1)*P: вычитаем P и выбираем по маске
+    negP = *P;
+    fp_neg(&C.F, &negP.y, &negP.y);
+    ec_ppoint_add_affine(&C, &t, &acc, &negP);
+    ec_ppoint_cnd_copy(&C, &acc, &t, odd ^ 1);
+    ec_ppoint_to_jpoint(&C, R, &acc);
+}
+
+/* Функция сложения точек на эллиптической кривой
+   Параметры:
+     - R – результат (выходная точка)
+     - P, Q – входные точки
+     - p – модуль конечного поля
+     - a – коэффициент кривой
+*/
+void ec_point_add(EC_Point *R, const EC_Point *P, const EC_Point *Q, const mpz_t p, const mpz_t a) {
+    ec_ctx_t E;
+    ec_apoint_t aP, aQ;
+    ec_jpoint_t J;
+
+    ec_ctx_init_or_die(&E, p, a);
+    ec_apoint_from_point(&E, &aP, P);
+    ec_apoint_from_point(&E, &aQ, Q);
+
+    // Особые случаи (бесконечность, P == -Q, удвоение) обрабатываются внутри сложения
+    ec_jpoint_from_apoint(&E, &J, &aP);
+    ec_jpoint_add_affine(&E, &J, &J, &aQ);
+    ec_jpoint_to_apoint(&E, &aP, &J);
+    ec_apoint_to_point(&E, R, &aP);
+}
+
+void ec_point_mul_ct(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a,
+                     size_t bits) {
+    ec_ctx_t E;
+    ec_apoint_t aP;
+    ec_jpoint_t J;
+
+    ec_ctx_init_or_die(&E, p, a);
+    ec_apoint_from_point(&E, &aP, P);
+    ec_jpoint_mul_ct(&E, &J, k, &aP, bits);
+    ec_jpoint_to_apoint(&E, &aP, &J);
+    ec_apoint_to_point(&E, R, &aP);
+}
+
+/* Скалярное умножение: вычисляем R = k * P методом «двоичного разложения».
+   Параметры:
+     - R – результат (должна быть инициализирована)
+     - k – скаляр (mpz_t)
+     - P – исходная точка
+     - p – модуль конечного поля
+     - a – коэффициент кривой (используется при сложении)
+*/
+void ec_point_mul(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a) {
+    ec_ctx_t E;
+    ec_apoint_t aP;
+    ec_jpoint_t J;
+
+    ec_ctx_init_or_die(&E, p, a);
+    ec_apoint_from_point(&E, &aP, P);
+    ec_jpoint_mul(&E, &J, k, &aP);
+    ec_jpoint_to_apoint(&E, &aP, &J);
+    ec_apoint_to_point(&E, R, &aP);
+}
+
+/* R = k1 * P1 + k2 * P2: оба произведения остаются в якобиевых координатах,
+   к аффинным переходим один раз в конце */
+void ec_point_mul_add(EC_Point *R, const mpz_t k1, const EC_Point *P1,
+                      const mpz_t k2, const EC_Point *P2,
+                      const mpz_t p, const mpz_t a) {
+    ec_ctx_t E;
+    ec_apoint_t aP;
+    ec_jpoint_t J1, J2;
+
+    ec_ctx_init_or_die(&E, p, a);
+    ec_apoint_from_point(&E, &aP, P1);
+    ec_jpoint_mul(&E, &J1, k1, &aP);
+    ec_apoint_from_point(&E, &aP, P2);
+    ec_jpoint_mul(&E, &J2, k2, &aP);
+    ec_jpoint_add(&E, &J1, &J1, &J2);
+    ec_jpoint_to_apoint(&E, &aP, &J1);
+    ec_apoint_to_point(&E, R, &aP);
+}
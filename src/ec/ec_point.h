@@ -1,35 +1,131 @@
-#ifndef EC_POINT_H
-#define EC_POINT_H
-
-#include <gmp.h>
-
-/* Структура для представления точки эллиптической кривой.
-   Поле infinity принимает значение 1 для точки на бесконечности, 0 – для обычной точки. */
-typedef struct {
-    mpz_t x;
-    mpz_t y;
-    int infinity;
-} EC_Point;
-
-/* Инициализация точки (выделяются mpz_t для координат) */
-void ec_point_init(EC_Point *P);
-
-/* Очистка ресурсов, выделенных в точке */
-void ec_point_clear(EC_Point *P);
-
-/* Копирование точки: R = Q */
-void ec_point_copy(EC_Point *R, const EC_Point *Q);
-
-/* Функция для вычисления a mod m, результат положительный */
-void mod_mpz(mpz_t rop, const mpz_t a, const mpz_t m);
-
-/* Сложение двух точек P и Q на эллиптической кривой по модулю p с коэффициентом a.
-   Если одна из точек является точкой на бесконечности, возвращается другая.
-   Если P == -Q, возвращается точка на бесконечности. */
-void ec_point_add(EC_Point *R, const EC_Point *P, const EC_Point *Q, const mpz_t p, const mpz_t a);
-
-/* Скалярное умножение: вычисление R = k * P с использованием метода «двоичного разложения».
-   Все операции выполняются по модулю p. */
-void ec_point_mul(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a);
-
-#endif // EC_POINT_H
+#ifndef EC_POINT_H
+#define EC_POINT_H
+
+#include <gmp.h>
+#include "fp.h"
+
+/* Структура для представления точки эллиптической кривой.
+   Поле infinity принимает значение 1 для точки на бесконечности, 0 – для обычной точки. */
+typedef struct {
+    mpz_t x;
+    mpz_t y;
+    int infinity;
+} EC_Point;
+
+/* Инициализация точки (выделяются mpz_t для координат) */
+void ec_point_init(EC_Point *P);
+
+/* То же с памятью под координаты до bits бит: запись результата в такую
+   точку не обращается к куче (см. gost_workspace.h) */
+void ec_point_init2(EC_Point *P, mp_bitcnt_t bits);
+
+/* Очистка ресурсов, выделенных в точке */
+void ec_point_clear(EC_Point *P);
+
+/* Копирование точки: R = Q */
+void ec_point_copy(EC_Point *R, const EC_Point *Q);
+
+/* Функция для вычисления a mod m, результат положительный */
+void mod_mpz(mpz_t rop, const mpz_t a, const mpz_t m);
+
+/* Сложение двух точек P и Q на эллиптической кривой по модулю p с коэффициентом a.
+   Если одна из точек является точкой на бесконечности, возвращается другая.
+   Если P == -Q, возвращается точка на бесконечности. Здесь и в умножениях
+   ниже R может совпадать с любой из входных точек: входы переводятся во
+   внутреннее представление до записи результата. */
+void ec_point_add(EC_Point *R, const EC_Point *P, const EC_Point *Q, const mpz_t p, const mpz_t a);
+
+/* Скалярное умножение: вычисление R = k * P с использованием метода «двоичного разложения».
+   Все операции выполняются по модулю p. R должна быть инициализирована. */
+void ec_point_mul(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a);
+
+/* Скалярное умножение на секретный скаляр k (закрытый ключ, одноразовое число)
+   за время, не зависящее от k (см. ec_jpoint_mul_ct); bits — граница длины k. */
+void ec_point_mul_ct(EC_Point *R, const mpz_t k, const EC_Point *P, const mpz_t p, const mpz_t a,
+                     size_t bits);
+
+/* Вычисление R = k1 * P1 + k2 * P2 без промежуточного перехода к аффинным координатам
+   (основная операция проверки подписи). */
+void ec_point_mul_add(EC_Point *R, const mpz_t k1, const EC_Point *P1,
+                      const mpz_t k2, const EC_Point *P2,
+                      const mpz_t p, const mpz_t a);
+
+/* ---- Внутреннее представление на лимбах фиксированной длины ----
+   Публичный тип EC_Point остаётся на mpz_t и используется только на границе API;
+   вся арифметика внутри выполняется над fp_t без обращения к куче. */
+
+/* Контекст арифметики кривой y^2 = x^3 + a*x + b над GF(p) */
+typedef struct {
+    fp_ctx_t F;
+    fp_t a;           // коэффициент a в представлении поля
+    int a_is_m3;      // a = -3 mod p: используется ускоренное удвоение
+    int edwards;      // кривая эквивалентна скрученной кривой Эдвардса (см. ec_edwards.h)
+    int ed_e_is_one;
+    fp_t ed_e, ed_d;  // e*u^2 + v^2 = 1 + d*u^2*v^2
+    fp_t ed_s, ed_t;  // x = s*(1+v)/(1-v) + t, y = s*(1+v)/((1-v)*u)
+    int has_b;        // b3 заполнен (см. ec_complete.h)
+    fp_t b3;          // 3b для полных формул сложения
+} ec_ctx_t;
+
+/* Аффинная точка на лимбах */
+typedef struct {
+    fp_t x, y;
+    int infinity;
+} ec_apoint_t;
+
+/* Точка в якобиевых координатах: x = X/Z^2, y = Y/Z^3, Z = 0 — точка на бесконечности */
+typedef struct {
+    fp_t X, Y, Z;
+} ec_jpoint_t;
+
+/* Инициализация контекста кривой. Возвращает 0 при успехе, -1 при неподдерживаемом p. */
+int ec_ctx_init(ec_ctx_t *E, const mpz_t p, const mpz_t a);
+
+/* Преобразования между EC_Point и внутренними типами */
+void ec_apoint_from_point(const ec_ctx_t *E, ec_apoint_t *R, const EC_Point *P);
+void ec_apoint_to_point(const ec_ctx_t *E, EC_Point *R, const ec_apoint_t *P);
+void ec_jpoint_from_apoint(const ec_ctx_t *E, ec_jpoint_t *R, const ec_apoint_t *P);
+void ec_jpoint_to_apoint(const ec_ctx_t *E, ec_apoint_t *R, const ec_jpoint_t *P);
+
+/* Перевод n точек в аффинные координаты с одним обращением на все точки
+   (приём Монтгомери). R и P — разные массивы длины n. */
+void ec_points_normalize_batch(const ec_ctx_t *E, ec_apoint_t *R, const ec_jpoint_t *P, size_t n);
+
+void ec_jpoint_set_infinity(const ec_ctx_t *E, ec_jpoint_t *R);
+int  ec_jpoint_is_infinity(const ec_ctx_t *E, const ec_jpoint_t *P);
+
+/* R = 2P. Допускается R == P. */
+void ec_jpoint_dbl(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P);
+/* R = P + Q (обе точки в якобиевых координатах). Допускается R == P или R == Q. */
+void ec_jpoint_add(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P, const ec_jpoint_t *Q);
+/* R = P + Q, Q задана в аффинных координатах (смешанное сложение). Допускается R == P. */
+void ec_jpoint_add_affine(const ec_ctx_t *E, ec_jpoint_t *R, const ec_jpoint_t *P, const ec_apoint_t *Q);
+/* R = k * P, k >= 0 */
+void ec_jpoint_mul(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P);
+
+/* ---- Постоянное время для секретных скаляров ----
+   Регулярная запись скаляра: k' = k | 1 записывается ndig нечётными цифрами
+   d_i из {±1, ±3, ..., ±15} по основанию 16 (старшая цифра равна 1), так что
+   каждое окно даёт ровно одно сложение. Требуется 0 <= k < 2^(4*(ndig-1)).
+   Возвращает младший бит k: при 0 из результата нужно вычесть P. */
+#define EC_CT_MAX_DIGITS ((FP_MAX_BITS + 8) / 4 + 2)
+mp_limb_t ec_scalar_recode_regular(signed char *d, const mpz_t k, size_t ndig);
+
+/* Модуль цифры в виде индекса (|d| - 1)/2 и её знак, без ветвлений */
+size_t ec_digit_index(signed char d);
+mp_limb_t ec_digit_sign(signed char d);
+
+/* 1, если i == j, иначе 0 — без сравнения с ветвлением */
+mp_limb_t ec_ct_eq(size_t i, size_t j);
+
+/* Выбор tab[idx] из n точек с просмотром всей таблицы по маске */
+void ec_apoint_select(const ec_ctx_t *E, ec_apoint_t *R, const ec_apoint_t *tab, size_t n, size_t idx);
+
+/* R = k * P без ветвлений и обращений к памяти, зависящих от k: окно 4 бита
+   с регулярной записью, таблица нечётных кратных P..15P и выбор по маске,
+   полные формулы сложения (ec_complete.h), приведения в поле в режиме ct.
+   bits — открытая граница длины скаляров (обычно разрядность q); при k < 0
+   или k >= 2^bits используется ec_jpoint_mul. */
+void ec_jpoint_mul_ct(const ec_ctx_t *E, ec_jpoint_t *R, const mpz_t k, const ec_apoint_t *P, size_t bits);
+
+#endif // EC_POINT_H
@@ -0,0 +1,174 @@
+#include "ec_table.h"
+#include "ec_complete.h"
+#include <stdlib.h>
+
+/* Построение таблицы: строка окна i содержит нечётные кратные 1, 3, ..., 15 точки 2^(W*i)*P.
+   Точки считаются в якобиевых координатах и переводятся в аффинные одним пакетом. */
+int ec_table_init(ec_table_t *T, const EC_Point *P, const mpz_t p, const mpz_t a, size_t bits) {
+    ec_jpoint_t base, base2, *jp;
+
+    T->pts = T->buf = NULL;
+    if (ec_ctx_init(&T->E, p, a) != 0)
+        return -1;
+
+    T->bits = bits;
+    T->nwin = (bits + EC_TABLE_W - 1) / EC_TABLE_W + 1;   // +1 окно под перенос знаковой записи
+    T->buf = (ec_apoint_t *)malloc(EC_TABLE_SIZE(bits) * sizeof(ec_apoint_t));
+    jp = (ec_jpoint_t *)malloc(EC_TABLE_SIZE(bits) * sizeof(ec_jpoint_t));
+    if (!T->buf || !jp) {
+        free(T->buf);
+        free(jp);
+        T->buf = NULL;
+        return -1;
+    }
+    T->pts = T->buf;
+
+    ec_apoint_from_point(&T->E, &T->P, P);
+    ec_ctx_set_b(&T->E, &T->P);
+    ec_jpoint_from_apoint(&T->E, &base, &T->P);
+
+    for (size_t i = 0; i < T->nwin; i++) {
+        ec_jpoint_t *row = jp + i * EC_TABLE_ENTRIES;
+
+        row[0] = base;
+        ec_jpoint_dbl(&T->E, &base2, &base);
+        for (int j = 1; j < EC_TABLE_ENTRIES; j++)
+            ec_jpoint_add(&T->E, &row[j], &row[j - 1], &base2);
+        // row[last] = (2^W - 1) * base, следующая база 2^W * base
+        ec_jpoint_add(&T->E, &base, &row[EC_TABLE_ENTRIES - 1], &base);
+    }
+
+    ec_points_normalize_batch(&T->E, T->buf, jp, EC_TABLE_SIZE(bits));
+    free(jp);
+    return 0;
+}
+
+int ec_table_init_static(ec_table_t *T, const EC_Point *P, const mpz_t p, const mpz_t a,
+                         size_t bits, const ec_apoint_t *pts, size_t count) {
+    T->pts = T->buf = NULL;
+    if (count != EC_TABLE_SIZE(bits) || ec_ctx_init(&T->E, p, a) != 0)
+        return -1;
+
+    T->bits = bits;
+    T->nwin = (bits + EC_TABLE_W - 1) / EC_TABLE_W + 1;
+    ec_apoint_from_point(&T->E, &T->P, P);
+
+    // Нулевая строка начинается с самой P: дешёвая проверка, что массив от этой кривой
+    if (pts[0].infinity || !fp_equal(&T->E.F, &pts[0].x, &T->P.x) || !fp_equal(&T->E.F, &pts[0].y, &T->P.y))
+        return -1;
+    ec_ctx_set_b(&T->E, &T->P);
+    T->pts = pts;
+    return 0;
+}
+
+void ec_table_clear(ec_table_t *T) {
+    free(T->buf);
+    T->pts = T->buf = NULL;
+}
+
+/* Проверка разрядности скаляра и регулярная запись k | 1 нечётными цифрами по основанию 2^W
+   (возвращает младший бит k). При -1 умножение уже выполнено обычным способом. */
+static int ec_table_recode(const ec_table_t *T, ec_jpoint_t *R, const mpz_t k, signed char *d, mp_limb_t *odd) {
+    if (mpz_sgn(k) < 0 || mpz_sizeinbase(k, 2) > T->bits || T->nwin > EC_CT_MAX_DIGITS) {
+        ec_jpoint_mul(&T->E, R, k, &T->P);
+        return -1;
+    }
+    *odd = ec_scalar_recode_regular(d, k, T->nwin);
+    return 0;
+}
+
+/* Умножение по таблице: для каждого окна одно смешанное сложение, старшая цифра
+   всегда 1; для чётного k в конце вычитается P */
+void ec_jpoint_mul_table(const ec_table_t *T, ec_jpoint_t *R, const mpz_t k) {
+    const ec_ctx_t *E = &T->E;
+    signed char d[EC_CT_MAX_DIGITS];
+    ec_jpoint_t acc;
+    ec_apoint_t pt;
+    mp_limb_t odd;
+
+    if (ec_table_recode(T, R, k, d, &odd) != 0)
+        return;
+
+    ec_jpoint_from_apoint(E, &acc, &T->pts[(T->nwin - 1) * EC_TABLE_ENTRIES]);
+    for (size_t i = T->nwin - 1; i-- > 0;) {
+        pt = T->pts[i * EC_TABLE_ENTRIES + ec_digit_index(d[i])];
+        if (d[i] < 0)
+            fp_neg(&E->F, &pt.y, &pt.y);
+        ec_jpoint_add_affine(E, &acc, &acc, &pt);
+    }
+    if (!odd) {
+        pt = T->P;
+        fp_neg(&E->F, &pt.y, &pt.y);
+        ec_jpoint_add_affine(E, &acc, &acc, &pt);
+    }
+    *R = acc;
+}
+
+/* То же без ветвлений: точка строки выбирается по маске, сложение по полным формулам */
+void ec_jpoint_mul_table_ct(const ec_table_t *T, ec_jpoint_t *R, const mpz_t k) {
+    ec_ctx_t C = T->E;
+    signed char d[EC_CT_MAX_DIGITS];
+    ec_ppoint_t acc, t;
+    ec_apoint_t pt;
+    mp_limb_t odd;
+
+    if (ec_table_recode(T, R, k, d, &odd) != 0)
+        return;
+    C.F.ct = 1;
+
+    ec_ppoint_from_apoint(&C, &acc, &T->pts[(T->nwin - 1) * EC_TABLE_ENTRIES]);
+    for (size_t i = T->nwin - 1; i-- > 0;) {
+        ec_apoint_select(&C, &pt, T->pts + i * EC_TABLE_ENTRIES, EC_TABLE_ENTRIES, ec_digit_index(d[i]));
+        fp_cnd_neg(&C.F, &pt.y, &pt.y, ec_digit_sign(d[i]));
+        ec_ppoint_add_affine(&C, &acc, &acc, &pt);
+    }
+
+    pt = T->P;
+    fp_neg(&C.F, &pt.y, &pt.y);
+    ec_ppoint_add_affine(&C, &t, &acc, &pt);
+    ec_ppoint_cnd_copy(&C, &acc, &t, odd ^ 1);
+    ec_ppoint_to_jpoint(&C, R, &acc);
+}
+
+void ec_point_mul_table(EC_Point *R, const mpz_t k, const ec_table_t *T) {
+    ec_jpoint_t J;
+    ec_apoint_t A;
+
+    ec_jpoint_mul_table(T, &J, k);
+    ec_jpoint_to_apoint(&T->E, &A, &J);
+    ec_apoint_to_point(&T->E, R, &A);
+}
+
+void ec_point_mul_table_ct(EC_Point *R, const mpz_t k, const ec_table_t *T) {
+    ec_jpoint_t J;
+    ec_apoint_t A;
+
+    ec_jpoint_mul_table_ct(T, &J, k);
+    ec_jpoint_to_apoint(&T->E, &A, &J);
+    ec_apoint_to_point(&T->E, R, &A);
+}
+
+void ec_point_mul_add_table(EC_Point *R, const mpz_t k1, const ec_table_t *T,
+                            const mpz_t k2, const EC_Point *Q) {
+    ec_jpoint_t J1, J2;
+    ec_apoint_t A;
+
+    ec_jpoint_mul_table(T, &J1, k1);
+    ec_apoint_from_point(&T->E, &A, Q);
+    ec_jpoint_mul(&T->E, &J2, k2, &A);
+    ec_jpoint_add(&T->E, &J1, &J1, &J2);
+    ec_jpoint_to_apoint(&T->E, &A, &J1);
+    ec_apoint_to_point(&T->E, R, &A);
+}
+
+void ec_point_mul2_table(EC_Point *R, const mpz_t k1, const ec_table_t *T1,
+                         const mpz_t k2, const ec_table_t *T2) {
+    ec_jpoint_t J1, J2;
+    ec_apoint_t A;
+
+    ec_jpoint_mul_table(T1, &J1, k1);
+    ec_jpoint_mul_table(T2, &J2, k2);
+    ec_jpoint_add(&T1->E, &J1, &J1, &J2);
+    ec_jpoint_to_apoint(&T1->E, &A, &J1);
+    ec_apoint_to_point(&T1->E, R, &A);
+}
@@ -0,0 +1,71 @@
+#ifndef EC_TABLE_H
+#define EC_TABLE_H
+
+#include <gmp.h>
+#include "ec_point.h"
+
+/* Ширина окна таблицы фиксированной базы: цифры скаляра в знаковом представлении
+   по основанию 2^EC_TABLE_W лежат в [-2^(W-1), 2^(W-1)] */
+#define EC_TABLE_W        4
+#define EC_TABLE_ENTRIES  (1 << (EC_TABLE_W - 1))
+
+/* Раскладка точек таблицы; меняется вместе с форматом файлов предвычислений
+   и встроенных таблиц */
+#define EC_TABLE_FORMAT   2
+
+/* Таблица фиксированной базы: для каждого окна i хранятся аффинные точки
+   (2j+1) * 2^(W*i) * P, j = 0..EC_TABLE_ENTRIES-1 (нечётные кратные 1..15).
+   Скаляр записывается регулярно нечётными цифрами (см. ec_scalar_recode_regular),
+   поэтому умножение на скаляр из bits бит — ровно одно смешанное сложение на
+   окно и ни одного удвоения, а порядок операций не зависит от скаляра. */
+typedef struct {
+    ec_ctx_t E;             // контекст кривой, в представлении которого хранятся точки
+    ec_apoint_t P;          // базовая точка
+    size_t bits;            // максимальная разрядность скаляра
+    size_t nwin;            // число окон
+    const ec_apoint_t *pts; // nwin * EC_TABLE_ENTRIES точек
+    ec_apoint_t *buf;       // собственная память таблицы (NULL для встроенных таблиц)
+} ec_table_t;
+
+/* Число точек в таблице для скаляров длиной до bits бит */
+#define EC_TABLE_SIZE(bits) ((((bits) + EC_TABLE_W - 1) / EC_TABLE_W + 1) * EC_TABLE_ENTRIES)
+
+/* Построение таблицы для точки P на кривой (p, a) и скаляров длиной до bits бит.
+   Возвращает 0 при успехе, -1 при неподдерживаемом модуле или нехватке памяти. */
+int ec_table_init(ec_table_t *T, const EC_Point *P, const mpz_t p, const mpz_t a, size_t bits);
+
+/* Таблица поверх готового массива точек (например, сгенерированного заранее
+   и вкомпилированного в программу): строится только контекст кривой, точки
+   не копируются и не освобождаются. Массив должен быть получен для той же
+   кривой, базовой точки и разрядности в представлении этого же контекста.
+   Возвращает -1, если размер не совпадает или первая точка массива не равна P. */
+int ec_table_init_static(ec_table_t *T, const EC_Point *P, const mpz_t p, const mpz_t a,
+                         size_t bits, const ec_apoint_t *pts, size_t count);
+
+/* Освобождение памяти таблицы */
+void ec_table_clear(ec_table_t *T);
+
+/* R = k * P по таблице (внутреннее представление). Скаляры длиннее T->bits
+   и отрицательные значения обрабатываются обычным умножением. */
+void ec_jpoint_mul_table(const ec_table_t *T, ec_jpoint_t *R, const mpz_t k);
+
+/* R = k * P по таблице для секретного k: точка окна выбирается просмотром всей
+   строки по маске, знак цифры применяется без ветвления, сложение по полным
+   формулам (ec_complete.h), приведения в поле выполняются в режиме ct. Время
+   не зависит от k в пределах 0 <= k < 2^T->bits. */
+void ec_jpoint_mul_table_ct(const ec_table_t *T, ec_jpoint_t *R, const mpz_t k);
+
+/* R = k * P по таблице, результат в EC_Point (R должна быть инициализирована) */
+void ec_point_mul_table(EC_Point *R, const mpz_t k, const ec_table_t *T);
+void ec_point_mul_table_ct(EC_Point *R, const mpz_t k, const ec_table_t *T);
+
+/* R = k1 * P + k2 * Q, где P — база таблицы T (проверка подписи) */
+void ec_point_mul_add_table(EC_Point *R, const mpz_t k1, const ec_table_t *T,
+                            const mpz_t k2, const EC_Point *Q);
+
+/* R = k1 * P1 + k2 * P2 по двум таблицам одной кривой (например, базовой точки
+   и часто используемого открытого ключа) */
+void ec_point_mul2_table(EC_Point *R, const mpz_t k1, const ec_table_t *T1,
+                         const mpz_t k2, const ec_table_t *T2);
+
+#endif // EC_TABLE_H
@@ -0,0 +1,250 @@
+#include "ec_table_file.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char ec_table_file_magic[8] = {'G', 'O', 'S', 'T', 'T', 'B', 'L', '\0'};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t limb_bits;         // GMP_NUMB_BITS
+    uint32_t window;            // EC_TABLE_W
+    uint32_t point_size;        // sizeof(ec_apoint_t)
+    uint64_t count;             // число таблиц
+    uint64_t checksum;          // контрольная сумма данных после заголовка
+} ec_table_file_header_t;
+
+typedef struct {
+    uint64_t bits;              // разрядность скаляра
+    uint64_t npoints;           // EC_TABLE_SIZE(bits)
+    uint64_t offset;            // смещение точек от начала файла
+    uint64_t n;                 // число лимбов p
+    mp_limb_t p[FP_MAX_LIMBS];  // модуль кривой
+    mp_limb_t a[FP_MAX_LIMBS];  // коэффициент a, 0 <= a < p (не в форме Монтгомери)
+} ec_table_file_entry_t;
+
+static size_t ec_table_file_align(size_t off) {
+    return (off + EC_TABLE_FILE_ALIGN - 1) / EC_TABLE_FILE_ALIGN * EC_TABLE_FILE_ALIGN;
+}
+
+/* FNV-1a по 64-битным словам; длина данных кратна 8 */
+static uint64_t ec_table_file_checksum(const unsigned char *data, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL, w;
+
+    for (size_t i = 0; i + sizeof(w) <= len; i += sizeof(w)) {
+        memcpy(&w, data + i, sizeof(w));
+        h = (h ^ w) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+int ec_table_file_save(const char *path, const ec_table_t *const tables[], size_t count) {
+    ec_table_file_header_t hdr;
+    ec_table_file_entry_t *ent;
+    unsigned char *buf;
+    size_t off, size;
+    char *tmp;
+    FILE *fp;
+    mpz_t t;
+    int ret = -1;
+
+    // Раскладка: заголовок, каталог, затем выровненные массивы точек
+    off = ec_table_file_align(sizeof(hdr) + count * sizeof(*ent));
+    size = off;
+    for (size_t i = 0; i < count; i++)
+        size = ec_table_file_align(size + tables[i]->nwin * EC_TABLE_ENTRIES * sizeof(ec_apoint_t));
+
+    buf = (unsigned char *)calloc(1, size);
+    tmp = (char *)malloc(strlen(path) + 5);
+    if (!buf || !tmp) {
+        free(buf);
+        free(tmp);
+        return -1;
+    }
+
+    mpz_init(t);
+    ent = (ec_table_file_entry_t *)(buf + sizeof(hdr));
+    for (size_t i = 0; i < count; i++) {
+        const ec_table_t *T = tables[i];
+        const fp_ctx_t *F = &T->E.F;
+        ec_apoint_t *pts = (ec_apoint_t *)(buf + off);
+
+        ent[i].bits = T->bits;
+        ent[i].npoints = T->nwin * EC_TABLE_ENTRIES;
+        ent[i].offset = off;
+        ent[i].n = (uint64_t)F->n;
+        mpn_copyi(ent[i].p, F->p, F->n);
+        fp_to_mpz(F, t, &T->E.a);
+        mpn_copyi(ent[i].a, mpz_limbs_read(t), (mp_size_t)mpz_size(t));
+
+        // Поэлементно, чтобы неиспользуемые лимбы и выравнивание в файле были нулевыми
+        for (size_t j = 0; j < ent[i].npoints; j++) {
+            mpn_copyi(pts[j].x.v, T->pts[j].x.v, F->n);
+            mpn_copyi(pts[j].y.v, T->pts[j].y.v, F->n);
+            pts[j].infinity = T->pts[j].infinity;
+        }
+        off = ec_table_file_align(off + ent[i].npoints * sizeof(ec_apoint_t));
+    }
+    mpz_clear(t);
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ec_table_file_magic, sizeof(hdr.magic));
+    hdr.version = EC_TABLE_FILE_VERSION;
+    hdr.limb_bits = GMP_NUMB_BITS;
+    hdr.window = EC_TABLE_W;
+    hdr.point_size = sizeof(ec_apoint_t);
+    hdr.count = count;
+    hdr.checksum = ec_table_file_checksum(buf + sizeof(hdr), size - sizeof(hdr));
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    sprintf(tmp, "%s.tmp", path);
+    fp = fopen(tmp, "wb");
+    if (fp) {
+        int ok = fwrite(buf, 1, size, fp) == size;
+        if (fclose(fp) == 0 && ok) {
+#ifdef _WIN32
+            remove(path);
+#endif
+            if (rename(tmp, path) == 0)
+                ret = 0;
+        }
+        if (ret != 0)
+            remove(tmp);
+    }
+
+    free(tmp);
+    free(buf);
+    return ret;
+}
+
+/* Проверка заголовка, каталога и контрольной суммы отображённого файла */
+static int ec_table_file_check(const ec_table_file_t *TF) {
+    const unsigned char *data = (const unsigned char *)TF->data;
+    const ec_table_file_header_t *hdr = (const ec_table_file_header_t *)data;
+    const ec_table_file_entry_t *ent = (const ec_table_file_entry_t *)(data + sizeof(*hdr));
+
+    if (TF->size < sizeof(*hdr) || TF->size % sizeof(uint64_t) != 0 ||
+        memcmp(hdr->magic, ec_table_file_magic, sizeof(hdr->magic)) != 0 ||
+        hdr->version != EC_TABLE_FILE_VERSION || hdr->limb_bits != GMP_NUMB_BITS ||
+        hdr->window != EC_TABLE_W || hdr->point_size != sizeof(ec_apoint_t) ||
+        hdr->count > (TF->size - sizeof(*hdr)) / sizeof(*ent))
+        return -1;
+
+    for (uint64_t i = 0; i < hdr->count; i++) {
+        if (ent[i].n == 0 || ent[i].n > FP_MAX_LIMBS || ent[i].bits > 2 * FP_MAX_BITS ||
+            ent[i].npoints != EC_TABLE_SIZE(ent[i].bits) ||
+            ent[i].offset % EC_TABLE_FILE_ALIGN != 0 ||
+            ent[i].offset < sizeof(*hdr) + hdr->count * sizeof(*ent) ||
+            ent[i].offset > TF->size ||
+            ent[i].npoints > (TF->size - ent[i].offset) / sizeof(ec_apoint_t))
+            return -1;
+    }
+
+    if (ec_table_file_checksum(data + sizeof(*hdr), TF->size - sizeof(*hdr)) != hdr->checksum)
+        return -1;
+    return 0;
+}
+
+int ec_table_file_open(ec_table_file_t *TF, const char *path) {
+    TF->data = NULL;
+    TF->size = 0;
+    TF->mapped = 0;
+
+#ifndef _WIN32
+    struct stat st;
+    void *map;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return -1;
+    TF->data = map;
+    TF->size = (size_t)st.st_size;
+    TF->mapped = 1;
+#else
+    // Без mmap файл читается в кучу целиком
+    FILE *fp = fopen(path, "rb");
+    long size;
+
+    if (!fp)
+        return -1;
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) <= 0) {
+        fclose(fp);
+        return -1;
+    }
+    rewind(fp);
+    TF->data = malloc((size_t)size);
+    if (!TF->data || fread(TF->data, 1, (size_t)size, fp) != (size_t)size) {
+        fclose(fp);
+        free(TF->data);
+        TF->data = NULL;
+        return -1;
+    }
+    fclose(fp);
+    TF->size = (size_t)size;
+#endif
+
+    if (ec_table_file_check(TF) != 0) {
+        ec_table_file_close(TF);
+        return -1;
+    }
+    return 0;
+}
+
+int ec_table_file_find(const ec_table_file_t *TF, ec_table_t *T, const EC_Point *P,
+                       const mpz_t p, const mpz_t a, size_t bits) {
+    const unsigned char *data = (const unsigned char *)TF->data;
+    const ec_table_file_header_t *hdr = (const ec_table_file_header_t *)data;
+    const ec_table_file_entry_t *ent = (const ec_table_file_entry_t *)(data + sizeof(*hdr));
+    mp_limb_t pl[FP_MAX_LIMBS] = {0}, al[FP_MAX_LIMBS] = {0};
+    mp_size_t n = (mp_size_t)mpz_size(p);
+    mpz_t t;
+
+    if (!data || mpz_sgn(p) <= 0 || n > FP_MAX_LIMBS)
+        return -1;
+
+    mpn_copyi(pl, mpz_limbs_read(p), n);
+    mpz_init(t);
+    mpz_mod(t, a, p);
+    mpn_copyi(al, mpz_limbs_read(t), (mp_size_t)mpz_size(t));
+    mpz_clear(t);
+
+    for (uint64_t i = 0; i < hdr->count; i++) {
+        if (ent[i].bits != bits || ent[i].n != (uint64_t)n ||
+            mpn_cmp(ent[i].p, pl, FP_MAX_LIMBS) != 0 || mpn_cmp(ent[i].a, al, FP_MAX_LIMBS) != 0)
+            continue;
+        // Первая точка таблицы сверяется с P внутри ec_table_init_static
+        if (ec_table_init_static(T, P, p, a, bits, (const ec_apoint_t *)(data + ent[i].offset),
+                                 (size_t)ent[i].npoints) == 0)
+            return 0;
+    }
+    return -1;
+}
+
+void ec_table_file_close(ec_table_file_t *TF) {
+#ifndef _WIN32
+    if (TF->mapped && TF->data)
+        munmap(TF->data, TF->size);
+#endif
+    if (!TF->mapped)
+        free(TF->data);
+    TF->data = NULL;
+    TF->size = 0;
+    TF->mapped = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef EC_TABLE_FILE_H
+#define EC_TABLE_FILE_H
+
+#include <stddef.h>
+#include <gmp.h>
+#include "ec_point.h"
+#include "ec_table.h"
+
+/* Файл предвычислений: набор таблиц фиксированной базы (для базовых точек
+   пользовательских кривых и часто используемых открытых ключей Q), которые
+   процессы отображают в память только для чтения вместо того, чтобы строить
+   заново. Все процессы на машине разделяют одну копию в страничном кэше.
+
+   Формат (порядок байт и представление лимбов — машинные):
+     заголовок: сигнатура, версия, размер лимба, ширина окна, размер точки,
+                число таблиц, контрольная сумма всего, что идёт после заголовка;
+     каталог:   для каждой таблицы разрядность скаляра, число точек, смещение
+                точек, модуль p и коэффициент a кривой;
+     точки:     массивы ec_apoint_t, выровненные на EC_TABLE_FILE_ALIGN байт.
+   Версия файла совпадает с раскладкой таблиц EC_TABLE_FORMAT; файл с другой
+   версией, размером лимба или окном не открывается. */
+#define EC_TABLE_FILE_VERSION EC_TABLE_FORMAT
+#define EC_TABLE_FILE_ALIGN   64
+
+typedef struct {
+    void *data;         // содержимое файла
+    size_t size;
+    int mapped;         // 1 — отображение mmap, 0 — копия в куче (системы без mmap)
+} ec_table_file_t;
+
+/* Запись count таблиц в файл path. Файл пишется во временный path.tmp и
+   атомарно переименовывается, поэтому процессы, открывающие его в это
+   время, видят либо старую, либо новую версию. Возвращает 0 при успехе. */
+int ec_table_file_save(const char *path, const ec_table_t *const tables[], size_t count);
+
+/* Открытие файла и проверка заголовка, каталога и контрольной суммы.
+   Возвращает 0 при успехе, -1 при ошибке чтения или повреждённом файле. */
+int ec_table_file_open(ec_table_file_t *TF, const char *path);
+
+/* Поиск в файле таблицы для точки P на кривой (p, a) и скаляров до bits бит.
+   Найденная таблица ссылается на точки в отображённом файле без копирования
+   и действительна, пока файл открыт. Возвращает 0, если таблица найдена. */
+int ec_table_file_find(const ec_table_file_t *TF, ec_table_t *T, const EC_Point *P,
+                       const mpz_t p, const mpz_t a, size_t bits);
+
+/* Закрытие файла (таблицы, полученные из него, после этого использовать нельзя) */
+void ec_table_file_close(ec_table_file_t *TF);
+
+#endif // EC_TABLE_FILE_H
@@ -0,0 +1,327 @@
+#include "fp.h"
+#include "fp_safegcd.h"
+#include <string.h>
+
+/* Граница малого c: произведения c*c и c*(c+1) укладываются в один лимб */
+#define FP_PM_MAX_C (GMP_NUMB_MAX >> (GMP_NUMB_BITS / 2 + 1))
+
+/* Константы Монтгомери: -p^{-1} mod 2^GMP_NUMB_BITS (итерации Ньютона), W mod p и W^2 mod p */
+static void fp_init_mont(fp_ctx_t *F, const mpz_t p, const mpz_t w) {
+    mp_limb_t p0 = F->p[0], inv = p0;     // p0*p0 = 1 (mod 8): верны 3 младших бита
+    mpz_t t;
+
+    for (int i = 0; i < 6; i++)
+        inv *= 2 - p0 * inv;
+    F->pinv = -inv;
+
+    mpz_init(t);
+    mpz_mod(t, w, p);
+    mpn_zero(F->one.v, F->n);
+    mpn_copyi(F->one.v, mpz_limbs_read(t), (mp_size_t)mpz_size(t));
+    mpz_mul(t, t, t);
+    mpz_mod(t, t, p);
+    mpn_zero(F->r2.v, F->n);
+    mpn_copyi(F->r2.v, mpz_limbs_read(t), (mp_size_t)mpz_size(t));
+    mpz_clear(t);
+}
+
+/* Распознавание модулей, для которых W = 2^(n*GMP_NUMB_BITS) сравнимо с +c или -c
+   при малом c. Старший бит p должен быть в старшем или предпоследнем бите
+   последнего лимба, чтобы итоговое приведение требовало не более пары вычитаний.
+   Остальные модули обрабатываются в форме Монтгомери. */
+static void fp_select_reduction(fp_ctx_t *F, const mpz_t p) {
+    mpz_t w;
+
+    mpz_init(w);
+    mpz_setbit(w, (mp_bitcnt_t)F->n * GMP_NUMB_BITS);
+    F->red = FP_RED_MONT;
+    fp_init_mont(F, p, w);
+
+    if (F->n >= 2 && mpz_sizeinbase(p, 2) + 1 >= (size_t)F->n * GMP_NUMB_BITS) {
+        mpz_mod(w, w, p);
+        if (mpz_cmp_ui(w, FP_PM_MAX_C) <= 0) {
+            F->red = FP_RED_PM_MINUS;
+            F->c = mpz_get_ui(w);
+        } else {
+            mpz_sub(w, p, w);
+            if (mpz_cmp_ui(w, FP_PM_MAX_C) <= 0) {
+                F->red = FP_RED_PM_PLUS;
+                F->c = mpz_get_ui(w);
+            }
+        }
+    }
+
+    // Число вычитаний p, достаточное для приведения результата редукции в режиме ct:
+    // REDC даёт значение меньше 2p, свёртки — меньше W и 2W соответственно
+    if (F->red == FP_RED_MONT) {
+        F->nsub = 1;
+    } else {
+        mpz_set_ui(w, 0);
+        mpz_setbit(w, (mp_bitcnt_t)F->n * GMP_NUMB_BITS + (F->red == FP_RED_PM_PLUS));
+        mpz_sub_ui(w, w, 1);
+        mpz_fdiv_q(w, w, p);
+        F->nsub = (int)mpz_get_ui(w);
+    }
+    mpz_clear(w);
+}
+
+/* Инициализация контекста поля */
+int fp_ctx_init(fp_ctx_t *F, const mpz_t p) {
+    if (mpz_cmp_ui(p, 3) < 0 || mpz_even_p(p) || mpz_sizeinbase(p, 2) > FP_MAX_BITS)
+        return -1;
+
+    memset(F, 0, sizeof(*F));
+    F->n = (mp_size_t)mpz_size(p);
+    mpn_copyi(F->p, mpz_limbs_read(p), F->n);
+    fp_select_reduction(F, p);
+    return 0;
+}
+
+/* r = cond ? b : a по маске, без ветвлений */
+static void fp_select_limbs(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b,
+                            mp_limb_t cond, mp_size_t n) {
+    mp_limb_t m = (mp_limb_t)0 - cond;
+    for (mp_size_t i = 0; i < n; i++)
+        r[i] = a[i] ^ (m & (a[i] ^ b[i]));
+}
+
+/* t += v с переносом через все n лимбов (без раннего выхода, как у mpn_add_1) */
+static mp_limb_t fp_add_1(mp_limb_t *t, mp_size_t n, mp_limb_t v) {
+    for (mp_size_t i = 0; i < n; i++) {
+        t[i] += v;
+        v = t[i] < v;
+    }
+    return v;
+}
+
+/* Приведение значения cy*W + t (cy — 0 или 1) в диапазон [0, p).
+   В режиме ct выполняется фиксированное число вычитаний с выбором по маске. */
+static void fp_final_sub(const fp_ctx_t *F, mp_limb_t *t, mp_limb_t cy, int nsub) {
+    if (F->ct) {
+        mp_limb_t tmp[FP_MAX_LIMBS], b;
+        for (int i = 0; i < nsub; i++) {
+            b = mpn_sub_n(tmp, t, F->p, F->n);
+            fp_select_limbs(t, t, tmp, cy | (b ^ 1), F->n);
+            cy &= b ^ 1;
+        }
+        return;
+    }
+    while (cy || mpn_cmp(t, F->p, F->n) >= 0)
+        cy -= mpn_sub_n(t, t, F->p, F->n);
+}
+
+/* W = c (mod p): t = H*W + L сворачивается в L + c*H; перенос второй свёртки
+   меньше c^2 и укладывается в лимб. */
+static void fp_reduce_pm_minus(const fp_ctx_t *F, fp_t *r, mp_limb_t *t) {
+    mp_size_t n = F->n;
+    mp_limb_t cy;
+
+    cy = mpn_addmul_1(t, t + n, n, F->c);
+    cy = fp_add_1(t, n, cy * F->c);
+    fp_add_1(t, n, cy * F->c);               // t здесь мало, переноса нет
+    fp_final_sub(F, t, 0, F->nsub);
+    mpn_copyi(r->v, t, n);
+}
+
+/* W = -c (mod p): t = H*W + L сворачивается в L - c*H. Заём b означает,
+   что к результату прибавлен b*W = -b*c, поэтому добавляем b*c обратно. */
+static void fp_reduce_pm_plus(const fp_ctx_t *F, fp_t *r, mp_limb_t *t) {
+    mp_size_t n = F->n;
+    mp_limb_t b, cy;
+
+    b = mpn_submul_1(t, t + n, n, F->c);
+    cy = fp_add_1(t, n, b * F->c);
+    fp_final_sub(F, t, cy, F->nsub);
+    mpn_copyi(r->v, t, n);
+}
+
+/* Редукция Монтгомери REDC: r = t * W^{-1} mod p для t < p*W.
+   Перенос i-го шага сохраняется в обнулённый лимб t[i] и прибавляется к старшей половине в конце. */
+static void fp_redc(const fp_ctx_t *F, fp_t *r, mp_limb_t *t) {
+    mp_size_t n = F->n;
+    mp_limb_t cy;
+
+    for (mp_size_t i = 0; i < n; i++)
+        t[i] = mpn_addmul_1(t + i, F->p, n, t[i] * F->pinv);
+    cy = mpn_add_n(r->v, t + n, t, n);
+    fp_final_sub(F, r->v, cy, 1);
+}
+
+/* Редукция произведения t (2n лимбов) по модулю p. Все буферы фиксированного
+   размера в стеке, без обращения к куче. Содержимое t портится. */
+static void fp_reduce(const fp_ctx_t *F, fp_t *r, mp_limb_t *t) {
+    switch (F->red) {
+    case FP_RED_PM_MINUS:
+        fp_reduce_pm_minus(F, r, t);
+        break;
+    case FP_RED_PM_PLUS:
+        fp_reduce_pm_plus(F, r, t);
+        break;
+    default:
+        fp_redc(F, r, t);
+        break;
+    }
+}
+
+void fp_from_mpz(const fp_ctx_t *F, fp_t *r, const mpz_t a) {
+    mpz_t t, pz;
+    mpz_roinit_n(pz, F->p, F->n);
+
+    memset(r->v, 0, sizeof(r->v));
+    if (mpz_sgn(a) >= 0 && mpz_cmp(a, pz) < 0) {
+        // Уже в диапазоне [0, p): просто копируем лимбы
+        mpn_copyi(r->v, mpz_limbs_read(a), (mp_size_t)mpz_size(a));
+    } else {
+        mpz_init(t);
+        mpz_mod(t, a, pz);
+        mpn_copyi(r->v, mpz_limbs_read(t), (mp_size_t)mpz_size(t));
+        mpz_clear(t);
+    }
+
+    if (F->red == FP_RED_MONT)
+        fp_mul(F, r, r, &F->r2);              // a*W^2*W^{-1} = a*W
+}
+
+void fp_to_mpz(const fp_ctx_t *F, mpz_t r, const fp_t *a) {
+    mp_limb_t *dst = mpz_limbs_write(r, F->n);
+
+    if (F->red == FP_RED_MONT) {
+        mp_limb_t t[2 * FP_MAX_LIMBS];
+        fp_t std;
+        mpn_copyi(t, a->v, F->n);
+        mpn_zero(t + F->n, F->n);
+        fp_redc(F, &std, t);                  // a*W * W^{-1} = a
+        mpn_copyi(dst, std.v, F->n);
+    } else {
+        mpn_copyi(dst, a->v, F->n);
+    }
+    mpz_limbs_finish(r, F->n);
+}
+
+/* a < W: свёртки принимают любое значение меньше W^2, REDC — меньше p*W.
+   В форме Монтгомери REDC даёт a*W^{-1}, два умножения на W^2 — a*W. */
+void fp_from_limbs(const fp_ctx_t *F, fp_t *r, const mp_limb_t *a, mp_size_t an) {
+    mp_limb_t t[2 * FP_MAX_LIMBS] = {0};
+
+    mpn_copyi(t, a, an);
+    fp_reduce(F, r, t);
+    if (F->red == FP_RED_MONT) {
+        fp_mul(F, r, r, &F->r2);
+        fp_mul(F, r, r, &F->r2);
+    }
+}
+
+void fp_set_ui(const fp_ctx_t *F, fp_t *r, unsigned long a) {
+    if (F->red == FP_RED_MONT && a == 1) {
+        fp_copy(F, r, &F->one);
+        return;
+    }
+    mpn_zero(r->v, F->n);
+    r->v[0] = (mp_limb_t)a;
+    if (F->red == FP_RED_MONT && a != 0)
+        fp_mul(F, r, r, &F->r2);
+}
+
+void fp_copy(const fp_ctx_t *F, fp_t *r, const fp_t *a) {
+    if (r != a)
+        mpn_copyi(r->v, a->v, F->n);
+}
+
+int fp_is_zero(const fp_ctx_t *F, const fp_t *a) {
+    return mpn_zero_p(a->v, F->n);
+}
+
+int fp_equal(const fp_ctx_t *F, const fp_t *a, const fp_t *b) {
+    return mpn_cmp(a->v, b->v, F->n) == 0;
+}
+
+void fp_add(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b) {
+    mp_limb_t carry = mpn_add_n(r->v, a->v, b->v, F->n);
+    if (F->ct)
+        fp_final_sub(F, r->v, carry, 1);
+    else if (carry || mpn_cmp(r->v, F->p, F->n) >= 0)
+        mpn_sub_n(r->v, r->v, F->p, F->n);
+}
+
+void fp_sub(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b) {
+    mp_limb_t borrow = mpn_sub_n(r->v, a->v, b->v, F->n);
+    mpn_cnd_add_n(borrow, r->v, r->v, F->p, F->n);
+}
+
+/* r = 0 - a: заём есть при любом a != 0, тогда прибавляем p */
+void fp_neg(const fp_ctx_t *F, fp_t *r, const fp_t *a) {
+    mp_limb_t zero[FP_MAX_LIMBS] = {0};
+    mp_limb_t borrow = mpn_sub_n(r->v, zero, a->v, F->n);
+    mpn_cnd_add_n(borrow, r->v, r->v, F->p, F->n);
+}
+
+void fp_cnd_copy(const fp_ctx_t *F, fp_t *r, const fp_t *a, mp_limb_t cond) {
+    fp_select_limbs(r->v, r->v, a->v, cond, F->n);
+}
+
+void fp_cnd_neg(const fp_ctx_t *F, fp_t *r, const fp_t *a, mp_limb_t cond) {
+    fp_t t;
+    fp_neg(F, &t, a);
+    fp_select_limbs(r->v, a->v, t.v, cond, F->n);
+}
+
+void fp_mul(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b) {
+    mp_limb_t t[2 * FP_MAX_LIMBS];
+    mpn_mul_n(t, a->v, b->v, F->n);
+    fp_reduce(F, r, t);
+}
+
+void fp_sqr(const fp_ctx_t *F, fp_t *r, const fp_t *a) {
+    mp_limb_t t[2 * FP_MAX_LIMBS];
+    mpn_sqr(t, a->v, F->n);
+    fp_reduce(F, r, t);
+}
+
+/* Сумма произведений меньше 2*p^2 < 2*p*W: если её старшая половина (с переносом)
+   не меньше p, из неё вычитается p, то есть из суммы — p*W, и редукции
+   (REDC требует t < p*W) получают значение меньше p*W < W^2. */
+void fp_mul_add(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b,
+                const fp_t *c, const fp_t *d) {
+    mp_limb_t t[2 * FP_MAX_LIMBS], u[2 * FP_MAX_LIMBS], cy, bw;
+    mp_size_t n = F->n;
+
+    mpn_mul_n(t, a->v, b->v, n);
+    mpn_mul_n(u, c->v, d->v, n);
+    cy = mpn_add_n(t, t, u, 2 * n);
+    bw = mpn_sub_n(u, t + n, F->p, n);
+    fp_select_limbs(t + n, t + n, u, cy | (bw ^ 1), n);
+    fp_reduce(F, r, t);
+}
+
+/* В форме Монтгомери safegcd даёт (a*W)^{-1} = a^{-1}*W^{-1}; два умножения на W^2 возвращают a^{-1}*W */
+void fp_inv(const fp_ctx_t *F, fp_t *r, const fp_t *a) {
+    fp_safegcd_inv(r->v, a->v, F->p, F->n);
+    if (F->red == FP_RED_MONT) {
+        fp_mul(F, r, r, &F->r2);
+        fp_mul(F, r, r, &F->r2);
+    }
+}
+
+/* Обращение возведением в степень p-2 (бинарный метод слева направо) */
+void fp_inv_fermat(const fp_ctx_t *F, fp_t *r, const fp_t *a) {
+    mp_limb_t e[FP_MAX_LIMBS];
+    fp_t base, acc;
+    int started = 0;
+
+    mpn_copyi(e, F->p, F->n);
+    mpn_sub_1(e, e, F->n, 2);
+    fp_copy(F, &base, a);
+    fp_set_ui(F, &acc, 1);
+
+    for (mp_size_t i = F->n; i-- > 0;) {
+        for (int bit = GMP_NUMB_BITS; bit-- > 0;) {
+            if (started)
+                fp_sqr(F, &acc, &acc);
+            if ((e[i] >> bit) & 1) {
+                fp_mul(F, &acc, &acc, &base);
+                started = 1;
+            }
+        }
+    }
+    fp_copy(F, r, &acc);
+}
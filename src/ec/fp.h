@@ -0,0 +1,78 @@
+#ifndef FP_H
+#define FP_H
+
+#include <gmp.h>
+
+/* Максимальная разрядность модуля поля (ГОСТ 34.10-2018 использует 256 и 512 бит) */
+#define FP_MAX_BITS  512
+#define FP_MAX_LIMBS ((FP_MAX_BITS + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS)
+
+/* Элемент конечного поля GF(p) с фиксированным хранением лимбов прямо в структуре.
+   Лимбы хранятся от младшего к старшему, используются первые n лимбов контекста.
+   Значение всегда полностью редуцировано: 0 <= v < p. */
+typedef struct {
+    mp_limb_t v[FP_MAX_LIMBS];
+} fp_t;
+
+/* Способы редукции, выбираются автоматически по виду модуля.
+   Для псевдомерсенновых модулей W = 2^(n*GMP_NUMB_BITS) сравнимо с малым +c или -c. */
+#define FP_RED_MONT      0   // общий случай: форма Монтгомери, REDC на лимбах (CryptoPro-C и пользовательские кривые)
+#define FP_RED_PM_MINUS  1   // W = +c (mod p): p = 2^256 - c, 2^512 - c (CryptoPro-A, tc26 512-A/C)
+#define FP_RED_PM_PLUS   2   // W = -c (mod p): p = 2^255 + c, 2^511 + c (пример из стандарта, CryptoPro-B, tc26 512-B)
+
+/* Контекст поля: модуль и всё, что нужно для редукции без выделения памяти.
+   При FP_RED_MONT элементы хранятся в форме Монтгомери a*W mod p на всём протяжении
+   вычислений; перевод выполняют только fp_from_mpz/fp_to_mpz/fp_set_ui. */
+typedef struct {
+    mp_size_t n;                   // число лимбов модуля
+    mp_limb_t p[FP_MAX_LIMBS];     // модуль p
+    int red;                       // способ редукции (FP_RED_*)
+    mp_limb_t c;                   // |W mod p| для псевдомерсенновых модулей
+    mp_limb_t pinv;                // -p^{-1} mod 2^GMP_NUMB_BITS (Монтгомери)
+    fp_t one;                      // W mod p — единица в форме Монтгомери
+    fp_t r2;                       // W^2 mod p — множитель перевода в форму Монтгомери
+    int ct;                        // 1 — итоговые приведения без ветвлений по данным (секретные значения)
+    int nsub;                      // число условных вычитаний p после редукции в режиме ct
+} fp_ctx_t;
+
+/* Инициализация контекста по модулю p. Возвращает 0 при успехе,
+   -1 если p чётный, меньше 3 или длиннее FP_MAX_BITS. */
+int fp_ctx_init(fp_ctx_t *F, const mpz_t p);
+
+/* Преобразования на границе API: mpz_t <-> элемент поля (a приводится по модулю p) */
+void fp_from_mpz(const fp_ctx_t *F, fp_t *r, const mpz_t a);
+void fp_to_mpz(const fp_ctx_t *F, mpz_t r, const fp_t *a);
+
+/* r = a mod p для числа из an <= n лимбов (младший первым), без mpz_t */
+void fp_from_limbs(const fp_ctx_t *F, fp_t *r, const mp_limb_t *a, mp_size_t an);
+
+void fp_set_ui(const fp_ctx_t *F, fp_t *r, unsigned long a);
+void fp_copy(const fp_ctx_t *F, fp_t *r, const fp_t *a);
+int  fp_is_zero(const fp_ctx_t *F, const fp_t *a);
+int  fp_equal(const fp_ctx_t *F, const fp_t *a, const fp_t *b);
+
+/* Арифметика по модулю p. Допускается совпадение r с любым из аргументов. */
+void fp_add(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b);
+void fp_sub(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b);
+void fp_neg(const fp_ctx_t *F, fp_t *r, const fp_t *a);
+void fp_mul(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b);
+void fp_sqr(const fp_ctx_t *F, fp_t *r, const fp_t *a);
+
+/* r = a*b + c*d с одной редукцией суммы произведений; в режиме ct без ветвлений по данным */
+void fp_mul_add(const fp_ctx_t *F, fp_t *r, const fp_t *a, const fp_t *b,
+                const fp_t *c, const fp_t *d);
+
+/* Операции без ветвлений и обращений к памяти, зависящих от данных:
+   r = a, если cond = 1, иначе r не меняется; r = -a, если cond = 1, иначе r = a.
+   cond — 0 или 1. */
+void fp_cnd_copy(const fp_ctx_t *F, fp_t *r, const fp_t *a, mp_limb_t cond);
+void fp_cnd_neg(const fp_ctx_t *F, fp_t *r, const fp_t *a, mp_limb_t cond);
+
+/* Обращение r = a^{-1} mod p за время, не зависящее от a (safegcd, см. fp_safegcd.h).
+   Для a = 0 результат 0. */
+void fp_inv(const fp_ctx_t *F, fp_t *r, const fp_t *a);
+
+/* То же возведением в степень p-2 (малая теорема Ферма); оставлено для сравнения в замерах */
+void fp_inv_fermat(const fp_ctx_t *F, fp_t *r, const fp_t *a);
+
+#endif // FP_H
@@ -0,0 +1,224 @@
+#include "fp_safegcd.h"
+#include <stdint.h>
+
+#ifdef __SIZEOF_INT128__
+
+#define FP_SAFEGCD_M62   ((uint64_t)-1 >> 2)
+/* Числа до 2m по модулю до FP_MAX_BITS бит со знаком, по 62 бита в слове */
+#define FP_SAFEGCD_LIMBS ((FP_MAX_BITS + 2) / 62 + 1)
+
+typedef __int128 fp_int128_t;
+
+/* Матрица перехода после 62 шагов: 2^62 * (f', g') = (u*f + v*g, q*f + r*g) */
+typedef struct {
+    int64_t u, v, q, r;
+} fp_safegcd_trans_t;
+
+/* 62 бита числа из лимбов начиная с бита pos */
+static int64_t fp_safegcd_get62(const mp_limb_t *a, mp_size_t n, size_t pos) {
+    uint64_t v = 0;
+
+    for (size_t b = 0; b < 62;) {
+        size_t bit = pos + b, off = bit % GMP_NUMB_BITS;
+        if (bit / GMP_NUMB_BITS >= (size_t)n)
+            break;
+        v |= (uint64_t)(a[bit / GMP_NUMB_BITS] >> off) << b;
+        b += GMP_NUMB_BITS - off;
+    }
+    return (int64_t)(v & FP_SAFEGCD_M62);
+}
+
+/* Обратное преобразование неотрицательного нормализованного числа в n лимбов */
+static void fp_safegcd_to_limbs(mp_limb_t *r, mp_size_t n, const int64_t *d, int len) {
+    mpn_zero(r, n);
+    for (int i = 0; i < len; i++) {
+        uint64_t v = (uint64_t)d[i];
+        size_t pos = 62 * (size_t)i;
+        for (size_t b = 0; b < 62;) {
+            size_t bit = pos + b, off = bit % GMP_NUMB_BITS;
+            if (bit / GMP_NUMB_BITS >= (size_t)n)
+                break;
+            r[bit / GMP_NUMB_BITS] |= (mp_limb_t)(v >> b) << off;
+            b += GMP_NUMB_BITS - off;
+        }
+    }
+}
+
+/* 62 шага divstep по младшим битам f и g:
+     delta > 0 и g нечётно: (delta, f, g) -> (1 - delta, g, (g - f)/2)
+     иначе:                 (delta, f, g) -> (1 + delta, f, (g + (g mod 2)*f)/2)
+   Обмен и прибавление выполняются по маскам. */
+static int64_t fp_safegcd_divsteps(int64_t delta, uint64_t f, uint64_t g, fp_safegcd_trans_t *t) {
+    uint64_t u = 1, v = 0, q = 0, r = 1, c1, c2, x;
+
+    for (int i = 0; i < 62; i++) {
+        // c1 — маска обмена: (f, g) -> (g, -f), (u, v, q, r) -> (q, r, -u, -v)
+        c1 = (uint64_t)((-delta) >> 63) & -(g & 1);
+        x = (f ^ g) & c1;
+        f ^= x;
+        g ^= x;
+        g = (g ^ c1) - c1;
+        x = (u ^ q) & c1;
+        u ^= x;
+        q ^= x;
+        q = (q ^ c1) - c1;
+        x = (v ^ r) & c1;
+        v ^= x;
+        r ^= x;
+        r = (r ^ c1) - c1;
+        delta = (delta ^ (int64_t)c1) - (int64_t)c1 + 1;
+
+        // g нечётно — прибавляем f, затем g /= 2 (вместо деления удваиваются u, v)
+        c2 = -(g & 1);
+        g += f & c2;
+        q += u & c2;
+        r += v & c2;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t->u = (int64_t)u;
+    t->v = (int64_t)v;
+    t->q = (int64_t)q;
+    t->r = (int64_t)r;
+    return delta;
+}
+
+/* (f, g) = (u*f + v*g, q*f + r*g) / 2^62; деление точное */
+static void fp_safegcd_update_fg(int64_t *f, int64_t *g, const fp_safegcd_trans_t *t, int len) {
+    fp_int128_t cf = (fp_int128_t)t->u * f[0] + (fp_int128_t)t->v * g[0];
+    fp_int128_t cg = (fp_int128_t)t->q * f[0] + (fp_int128_t)t->r * g[0];
+
+    cf >>= 62;
+    cg >>= 62;
+    for (int i = 1; i < len; i++) {
+        cf += (fp_int128_t)t->u * f[i] + (fp_int128_t)t->v * g[i];
+        cg += (fp_int128_t)t->q * f[i] + (fp_int128_t)t->r * g[i];
+        f[i - 1] = (int64_t)((uint64_t)cf & FP_SAFEGCD_M62);
+        g[i - 1] = (int64_t)((uint64_t)cg & FP_SAFEGCD_M62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f[len - 1] = (int64_t)cf;
+    g[len - 1] = (int64_t)cg;
+}
+
+/* (d, e) = (u*d + v*e, q*d + r*e) / 2^62 mod m: к числителям добавляется кратное m,
+   обнуляющее младшие 62 бита, и поправка за отрицательные d, e, так что
+   значения остаются в (-2m, m) */
+static void fp_safegcd_update_de(int64_t *d, int64_t *e, const fp_safegcd_trans_t *t,
+                                 const int64_t *m, uint64_t minv, int len) {
+    int64_t sd = d[len - 1] >> 63, se = e[len - 1] >> 63;
+    int64_t md = (t->u & sd) + (t->v & se), me = (t->q & sd) + (t->r & se);
+    fp_int128_t cd = (fp_int128_t)t->u * d[0] + (fp_int128_t)t->v * e[0];
+    fp_int128_t ce = (fp_int128_t)t->q * d[0] + (fp_int128_t)t->r * e[0];
+
+    md -= (int64_t)((minv * (uint64_t)cd + (uint64_t)md) & FP_SAFEGCD_M62);
+    me -= (int64_t)((minv * (uint64_t)ce + (uint64_t)me) & FP_SAFEGCD_M62);
+    cd += (fp_int128_t)m[0] * md;
+    ce += (fp_int128_t)m[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+    for (int i = 1; i < len; i++) {
+        cd += (fp_int128_t)t->u * d[i] + (fp_int128_t)t->v * e[i] + (fp_int128_t)m[i] * md;
+        ce += (fp_int128_t)t->q * d[i] + (fp_int128_t)t->r * e[i] + (fp_int128_t)m[i] * me;
+        d[i - 1] = (int64_t)((uint64_t)cd & FP_SAFEGCD_M62);
+        e[i - 1] = (int64_t)((uint64_t)ce & FP_SAFEGCD_M62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d[len - 1] = (int64_t)cd;
+    e[len - 1] = (int64_t)ce;
+}
+
+/* Перенос между словами: младшие слова в [0, 2^62), знак в старшем */
+static void fp_safegcd_carry(int64_t *d, int len) {
+    for (int i = 0; i + 1 < len; i++) {
+        d[i + 1] += d[i] >> 62;
+        d[i] &= (int64_t)FP_SAFEGCD_M62;
+    }
+}
+
+/* d += m, если d < 0 */
+static void fp_safegcd_cnd_add(int64_t *d, const int64_t *m, int len) {
+    int64_t mask = d[len - 1] >> 63;
+
+    for (int i = 0; i < len; i++)
+        d[i] += m[i] & mask;
+    fp_safegcd_carry(d, len);
+}
+
+int fp_safegcd_inv(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *m, mp_size_t n) {
+    int64_t f[FP_SAFEGCD_LIMBS], g[FP_SAFEGCD_LIMBS], d[FP_SAFEGCD_LIMBS] = {0},
+            e[FP_SAFEGCD_LIMBS] = {0}, mm[FP_SAFEGCD_LIMBS], delta = 1, sf;
+    size_t bits = mpn_sizeinbase(m, n, 2), steps;
+    int len = (int)((bits + 2) / 62 + 1), ok;
+    uint64_t minv = (uint64_t)m[0];
+    fp_safegcd_trans_t t;
+
+    // Граница числа шагов divstep из статьи Бернштейна — Янга для bits-битных входов
+    steps = bits < 46 ? (49 * bits + 80) / 17 : (49 * bits + 57) / 17;
+
+    for (int i = 0; i < len; i++) {
+        mm[i] = f[i] = fp_safegcd_get62(m, n, 62 * (size_t)i);
+        g[i] = fp_safegcd_get62(a, n, 62 * (size_t)i);
+    }
+    e[0] = 1;
+    for (int i = 0; i < 5; i++)                 // m^{-1} mod 2^62 итерациями Ньютона
+        minv *= 2 - (uint64_t)m[0] * minv;
+    minv &= FP_SAFEGCD_M62;
+
+    for (size_t s = 0; s < steps; s += 62) {
+        delta = fp_safegcd_divsteps(delta, (uint64_t)f[0], (uint64_t)g[0], &t);
+        fp_safegcd_update_de(d, e, &t, mm, minv, len);
+        fp_safegcd_update_fg(f, g, &t, len);
+    }
+
+    // g = 0, f = ±gcd(a, m), d*a = f (mod m); f переводится в |f|
+    sf = f[len - 1] >> 63;
+    for (int i = 0; i < len; i++)
+        f[i] = (f[i] ^ sf) - sf;
+    fp_safegcd_carry(f, len);
+    ok = f[0] == 1;
+    for (int i = 1; i < len; i++)
+        ok &= f[i] == 0;
+
+    fp_safegcd_cnd_add(d, mm, len);              // (-m, m)
+    for (int i = 0; i < len; i++)                 // знак f
+        d[i] = (d[i] ^ sf) - sf;
+    fp_safegcd_carry(d, len);
+    fp_safegcd_cnd_add(d, mm, len);              // [0, m)
+    fp_safegcd_to_limbs(r, n, d, len);
+    if (!ok)
+        mpn_zero(r, n);
+    return ok;
+}
+
+#else
+
+int fp_safegcd_inv(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *m, mp_size_t n) {
+    mp_limb_t ap[FP_MAX_LIMBS], tp[4 * FP_MAX_LIMBS];
+    mpz_t ar, mr, rr;
+    int ok;
+
+    mpn_copyi(ap, a, n);
+    if (mpn_sec_invert_itch(n) <= 4 * FP_MAX_LIMBS) {
+        ok = mpn_sec_invert(r, ap, m, n, 2 * (mp_bitcnt_t)n * GMP_NUMB_BITS, tp);
+        if (!ok)
+            mpn_zero(r, n);
+        return ok;
+    }
+
+    // Буфер mpn_sec_invert больше ожидаемого: обращение общего вида
+    mpz_roinit_n(ar, a, n);
+    mpz_roinit_n(mr, m, n);
+    mpz_init(rr);
+    ok = mpz_invert(rr, ar, mr) != 0;
+    mpn_zero(r, n);
+    if (ok)
+        mpn_copyi(r, mpz_limbs_read(rr), (mp_size_t)mpz_size(rr));
+    mpz_clear(rr);
+    return ok;
+}
+
+#endif // __SIZEOF_INT128__
@@ -0,0 +1,19 @@
+#ifndef FP_SAFEGCD_H
+#define FP_SAFEGCD_H
+
+#include <gmp.h>
+#include "fp.h"
+
+/* Обращение по нечётному модулю алгоритмом safegcd Бернштейна — Янга
+   («Fast constant-time gcd computation and modular inversion», 2019):
+   пакеты по 62 шага divstep на 64-битных словах с матрицей перехода 2x2,
+   которая затем применяется к числам в представлении по 62 бита.
+   Число итераций зависит только от разрядности модуля, ветвлений и
+   обращений к памяти, зависящих от a, нет.
+   Без 128-битных целых в компиляторе используется mpn_sec_invert из GMP. */
+
+/* r = a^{-1} mod m для нечётного m из n <= FP_MAX_LIMBS лимбов и 0 <= a < m.
+   Возвращает 1 при успехе, 0 если a не обратим (тогда r = 0 при a = 0). */
+int fp_safegcd_inv(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *m, mp_size_t n);
+
+#endif // FP_SAFEGCD_H
@@ -0,0 +1,112 @@
+#include "hmac_stribog.h"
+#include "stribog.h"
+
+size_t hmac_stribog_size(u8 size) {
+    return size ? OUTPUT_SIZE_512 : OUTPUT_SIZE_256;
+}
+
+void hmac_stribog_hash_init(hmac_stribog_hash_t *H, u8 size) {
+    struct stribog_ctx_t ctx;
+
+    init(&ctx, size);
+    memcpy(H->h, ctx.h, BLOCK_SIZE);
+    memcpy(H->N, ctx.N, BLOCK_SIZE);
+    memcpy(H->S, ctx.S, BLOCK_SIZE);
+    H->len = 0;
+    H->size = ctx.size;
+}
+
+/* Полный блок строки байт: stribog() принимает блоки в записи стандарта
+   (старший байт первым), поэтому байты блока переставляются в обратном порядке */
+static void hmac_stribog_hash_block(hmac_stribog_hash_t *H) {
+    u8 m[BLOCK_SIZE];
+    u8 i;
+
+    for (i = 0; i < BLOCK_SIZE; i++)
+        m[i] = H->buf[BLOCK_SIZE - 1 - i];
+    g_N(H->h, H->N, m);
+    addmod512_u32(H->N, H->N, BLOCK_BIT_SIZE);
+    addmod512(H->S, H->S, m);
+}
+
+void hmac_stribog_hash_update(hmac_stribog_hash_t *H, const u8 *data, size_t len) {
+    while (len > 0) {
+        size_t n = BLOCK_SIZE - H->len;
+        if (n > len)
+            n = len;
+        memcpy(H->buf + H->len, data, n);
+        H->len += n;
+        data += n;
+        len -= n;
+        if (H->len == BLOCK_SIZE) {
+            hmac_stribog_hash_block(H);
+            H->len = 0;
+        }
+    }
+}
+
+/* Последний неполный блок (возможно пустой) и финальные сжатия — та же
+   stribog() над остатком меньше блока; результат в порядке строки байт */
+void hmac_stribog_hash_final(hmac_stribog_hash_t *H, u8 *out) {
+    struct stribog_ctx_t ctx;
+    u8 tail[BLOCK_SIZE];
+    size_t i, n = hmac_stribog_size(H->size);
+
+    memcpy(ctx.h, H->h, BLOCK_SIZE);
+    memcpy(ctx.N, H->N, BLOCK_SIZE);
+    memcpy(ctx.S, H->S, BLOCK_SIZE);
+    ctx.size = H->size;
+    for (i = 0; i < H->len; i++)
+        tail[i] = H->buf[H->len - 1 - i];
+    stribog(&ctx, tail, H->len);
+    for (i = 0; i < n; i++)
+        out[i] = ctx.h[n - 1 - i];
+
+    memset(tail, 0, sizeof(tail));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+void hmac_stribog_init(hmac_stribog_ctx_t *ctx, u8 size, const u8 *key, size_t key_len) {
+    u8 pad[HMAC_STRIBOG_BLOCK] = {0};
+    size_t i;
+
+    if (key_len > HMAC_STRIBOG_BLOCK) {
+        hmac_stribog_hash_init(&ctx->inner, size);
+        hmac_stribog_hash_update(&ctx->inner, key, key_len);
+        hmac_stribog_hash_final(&ctx->inner, pad);
+    } else {
+        memcpy(pad, key, key_len);
+    }
+
+    for (i = 0; i < HMAC_STRIBOG_BLOCK; i++)
+        pad[i] ^= 0x36;
+    hmac_stribog_hash_init(&ctx->inner, size);
+    hmac_stribog_hash_update(&ctx->inner, pad, HMAC_STRIBOG_BLOCK);
+    for (i = 0; i < HMAC_STRIBOG_BLOCK; i++)
+        pad[i] ^= 0x36 ^ 0x5c;
+    hmac_stribog_hash_init(&ctx->outer, size);
+    hmac_stribog_hash_update(&ctx->outer, pad, HMAC_STRIBOG_BLOCK);
+    memset(pad, 0, sizeof(pad));
+}
+
+void hmac_stribog_update(hmac_stribog_ctx_t *ctx, const u8 *data, size_t len) {
+    hmac_stribog_hash_update(&ctx->inner, data, len);
+}
+
+void hmac_stribog_final(hmac_stribog_ctx_t *ctx, u8 *out) {
+    u8 t[OUTPUT_SIZE_512];
+
+    hmac_stribog_hash_final(&ctx->inner, t);
+    hmac_stribog_hash_update(&ctx->outer, t, hmac_stribog_size(ctx->outer.size));
+    hmac_stribog_hash_final(&ctx->outer, out);
+    memset(t, 0, sizeof(t));
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void hmac_stribog(u8 *out, u8 size, const u8 *key, size_t key_len, const u8 *msg, size_t msg_len) {
+    hmac_stribog_ctx_t ctx;
+
+    hmac_stribog_init(&ctx, size, key, key_len);
+    hmac_stribog_update(&ctx, msg, msg_len);
+    hmac_stribog_final(&ctx, out);
+}
@@ -0,0 +1,58 @@
+#ifndef _HMAC_STRIBOG_H
+#define _HMAC_STRIBOG_H
+
+#include <stddef.h>
+
+#include "types.h"
+
+/* HMAC на Стрибоге (Р 50.1.113-2016, RFC 7836): HMAC_K(T) = H((K ^ opad) || H((K ^ ipad) || T)),
+   блок 64 байта, ключ длиннее блока заменяется его хэшем. Ключ, сообщение и
+   результат — строки байт в порядке RFC 7836 (как у OpenSSL), а не числа в
+   записи стандарта, которые принимает однопроходная функция stribog().
+   Сообщение подаётся частями без буферизации целиком; состояние после ключа
+   можно скопировать присваиванием и использовать для нескольких сообщений
+   с тем же ключом, экономя по одному сжатию на каждом из двух проходов. */
+
+#define HMAC_STRIBOG_BLOCK  64
+
+// Размер хэша — те же значения, что в stribog.h
+#ifndef HASH512
+#define HASH256         0
+#define HASH512         1
+#endif
+
+/* Потоковый Стрибог над строкой байт: состояние функции сжатия и неполный блок */
+typedef struct {
+    u8 h[HMAC_STRIBOG_BLOCK];
+    u8 N[HMAC_STRIBOG_BLOCK];
+    u8 S[HMAC_STRIBOG_BLOCK];
+    u8 buf[HMAC_STRIBOG_BLOCK];
+    size_t len;                 // заполнено байт в buf
+    u8 size;                    // HASH256 или HASH512
+} hmac_stribog_hash_t;
+
+/* Стрибог над строкой байт, подаваемой частями (им же пользуются потоковые
+   подпись и проверка в gost3410.h); результат final — hmac_stribog_size(size)
+   байт в порядке строки байт RFC 7836. Подпись по хэшу (gost3410_sign_digest)
+   ждёт обратный порядок: хэш для неё завершается gost3410_stream_digest. */
+void hmac_stribog_hash_init(hmac_stribog_hash_t *H, u8 size);
+void hmac_stribog_hash_update(hmac_stribog_hash_t *H, const u8 *data, size_t len);
+void hmac_stribog_hash_final(hmac_stribog_hash_t *H, u8 *out);
+
+typedef struct {
+    hmac_stribog_hash_t inner;  // после блока K ^ ipad и поданных данных
+    hmac_stribog_hash_t outer;  // после блока K ^ opad
+} hmac_stribog_ctx_t;
+
+/* Длина результата в байтах: 32 для HASH256, 64 для HASH512 */
+size_t hmac_stribog_size(u8 size);
+
+void hmac_stribog_init(hmac_stribog_ctx_t *ctx, u8 size, const u8 *key, size_t key_len);
+void hmac_stribog_update(hmac_stribog_ctx_t *ctx, const u8 *data, size_t len);
+/* Результат в out (hmac_stribog_size(size) байт); ctx после вызова не используется */
+void hmac_stribog_final(hmac_stribog_ctx_t *ctx, u8 *out);
+
+/* HMAC одного сообщения */
+void hmac_stribog(u8 *out, u8 size, const u8 *key, size_t key_len, const u8 *msg, size_t msg_len);
+
+#endif
@@ -54,16 +54,10 @@ static void xor512(u8 *dst, u8 *a, u8 *b) {
     }
 }
 
-static void S(u8 *vect) {
-    u8 i;
-
-    for (i = 0; i < BLOCK_SIZE; i++) {
-        vect[i] = sbox[vect[i]];
-    }
-}
-
-static void LP(u8 *vect) {
-    u8 i, j, k;
+/* Преобразование LPS (подстановка, перестановка байт, линейное L) по таблицам Ax:
+   слово i результата — xor вкладов байтов vect[j*8 + i], j = 0..7 */
+static void LPS(u8 *vect) {
+    u8 i, j;
     u8 tmp[64];
     memcpy(tmp, vect, 64);
     u64 c;
@@ -71,10 +65,7 @@ static void LP(u8 *vect) {
     for (i = 0; i < 8; i++) {
         c = 0;
         for (j = 0; j < 8; j++) {
-            for (k = 0; k < 8; k++) {
-                if (tmp[j*8+i] & (0x80 >> k))
-                    c ^= A[j*8+k];
-            }
+            c ^= Ax[j][tmp[j*8+i]];
         }
         for (j = 0; j < 8; j++) {
             vect[i*8+j] = c >> ((7 - j) * 8);
@@ -93,11 +84,9 @@ static void E(u8 *dst, u8 *k, u8 *m) {
     X(dst, K, m);
 
     for (i = 1; i < 13; i++) {
-        S(dst);
-        LP(dst);
+        LPS(dst);
         X(K, K, C[i-1]);
-        S(K);
-        LP(K);
+        LPS(K);
         X(dst, K, dst);
     }
 }
@@ -106,8 +95,7 @@ static void g_N(u8 *h, u8 *N, u8 *m) {
     u8 hash[BLOCK_SIZE];
     memcpy(hash, h, BLOCK_SIZE);
     xor512(h, h, N);
-    S(h);
-    LP(h);
+    LPS(h);
     E(h, h, m);
     xor512(h, h, hash);
     xor512(h, h, m);
@@ -116,8 +104,7 @@ static void g_N(u8 *h, u8 *N, u8 *m) {
 static void g_0(u8 *h, u8 *m) {
     u8 hash[64];
     memcpy(hash, h, BLOCK_SIZE);
-    S(h);
-    LP(h);
+    LPS(h);
     E(h, h, m);
     xor512(h, h, hash);
     xor512(h, h, m);
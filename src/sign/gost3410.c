@@ -1,144 +1,921 @@
-#include "gost3410.h"
-#include "../hash/stribog.h"    // Предполагается, что здесь объявлены init() и stribog()
-#include "../hash/types.h"      // Определения u8, u64 и т.п.
-#include "../ec/ec_point.h"
-#include <gmp.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <time.h>
-#include <string.h>
-
-#define BLOCK_SIZE 64
-#define GREEN   "\033[0;32m"
-#define RED     "\033[0;31m"
-#define RESET   "\033[0m"
-
-/* Преобразование 64-байтного хэша в число mpz_t */
-static void hash_to_mpz(mpz_t out, const unsigned char hash[BLOCK_SIZE]) {
-    mpz_import(out, BLOCK_SIZE, 1, sizeof(unsigned char), 0, 0, hash);
-}
-
-/* Формирование подписи по ГОСТ 34.10–2018 */
-void gost3410_sign(mpz_t r, mpz_t s,
-                   const unsigned char *message, size_t message_len,
-                   const mpz_t d, const mpz_t q,
-                   const mpz_t p, const mpz_t a,
-                   const EC_Point *P) {
-    struct stribog_ctx_t ctx;
-    init(&ctx, HASH512);
-    stribog(&ctx, (u8 *)message, (u64)message_len);
-    unsigned char hash[BLOCK_SIZE];
-    memcpy(hash, ctx.h, BLOCK_SIZE);
-
-    mpz_t a_value, e;
-    mpz_inits(a_value, e, NULL);
-    mpz_import(a_value, 64, 1, 1, 0, 0, hash);
-    mpz_mod(e, a_value, q);
-    if (mpz_cmp_ui(e, 0) == 0)
-        mpz_set_ui(e, 1);
-
-    //gmp_printf(GREEN "=== DEBUG: e = %Zx ===\n" RESET, e);
-
-    gmp_randstate_t rand_state;
-    gmp_randinit_default(rand_state);
-    gmp_randseed_ui(rand_state, (unsigned long) time(NULL));
-
-    EC_Point C;
-    ec_point_init(&C);
-
-    mpz_t k, rd, ke, temp;
-    mpz_inits(k, rd, ke, temp, NULL);
-
-    while (1) {
-        mpz_urandomm(k, rand_state, q);
-        if (mpz_cmp_ui(k, 0) == 0)
-            continue;
-        ec_point_mul(&C, k, P, p, a);
-        if (C.infinity)
-            continue;
-        mpz_mod(r, C.x, q);
-        if (mpz_cmp_ui(r, 0) == 0)
-            continue;
-        mpz_mul(rd, r, d);
-        mpz_mul(ke, k, e);
-        mpz_add(temp, rd, ke);
-        mpz_mod(s, temp, q);
-        if (mpz_cmp_ui(s, 0) == 0)
-            continue;
-        break;
-    }
-
-    //gmp_printf(GREEN "k = %Zx\n" RESET, k);
-    //gmp_printf(GREEN "r = %Zx\n" RESET, r);
-    //gmp_printf(GREEN "s = %Zx\n" RESET, s);
-
-    ec_point_clear(&C);
-    mpz_clears(a_value, e, k, rd, ke, temp, NULL);
-    gmp_randclear(rand_state);
-}
-
-/* Проверка подписи по ГОСТ 34.10–2018 */
-int gost3410_verify(const unsigned char *message, size_t message_len,
-                    const mpz_t r, const mpz_t s,
-                    const EC_Point *Q,
-                    const mpz_t q, const mpz_t p, const mpz_t a,
-                    const EC_Point *P) {
-    if (mpz_cmp_ui(r, 0) <= 0 || mpz_cmp(r, q) >= 0 ||
-        mpz_cmp_ui(s, 0) <= 0 || mpz_cmp(s, q) >= 0)
-        return 0;
-
-    struct stribog_ctx_t ctx;
-    init(&ctx, HASH512);
-    stribog(&ctx, (u8 *)message, (u64)message_len);
-    unsigned char hash[BLOCK_SIZE];
-    memcpy(hash, ctx.h, BLOCK_SIZE);
-
-    //printf(RED "=== DEBUG: Hash of message ===\n" RESET);
-    //for (int i = 0; i < BLOCK_SIZE; i++) printf(RED "%02x" RESET, hash[i]);
-    //printf("\n\n");
-
-    mpz_t a_value, e, v, z1, z2, temp;
-    mpz_inits(a_value, e, v, z1, z2, temp, NULL);
-    hash_to_mpz(a_value, hash);
-    mpz_mod(e, a_value, q);
-    if (mpz_cmp_ui(e, 0) == 0)
-        mpz_set_ui(e, 1);
-
-    //gmp_printf(RED "e = %Zx\n" RESET, e);
-
-    if (mpz_invert(v, e, q) == 0) {
-        //printf(RED "=== DEBUG: Inverse of e does not exist! ===\n" RESET);
-        mpz_clears(a_value, e, v, z1, z2, temp, NULL);
-        return 0;
-    }
-
-    mpz_mul(z1, s, v);
-    mpz_mod(z1, z1, q);
-    mpz_neg(z2, r);
-    mpz_mul(z2, z2, v);
-    mpz_mod(z2, z2, q);
-
-    //gmp_printf(RED "z1 = %Zx\n" RESET, z1);
-    //gmp_printf(RED "z2 = %Zx\n\n" RESET, z2);
-
-    EC_Point R_point, temp1, temp2;
-    ec_point_init(&R_point);
-    ec_point_init(&temp1);
-    ec_point_init(&temp2);
-    ec_point_mul(&temp1, z1, P, p, a);
-    ec_point_mul(&temp2, z2, Q, p, a);
-    ec_point_add(&R_point, &temp1, &temp2, p, a);
-    mpz_mod(temp, R_point.x, q);
-
-    //gmp_printf(RED "R.x mod q = %Zx\n" RESET, temp);
-    //gmp_printf(RED "r from signature = %Zx\n\n" RESET, r);
-
-    int valid = (mpz_cmp(temp, r) == 0);
-    //printf(RED "=== DEBUG: Signature VALID? %s ===\n" RESET, valid ? "YES" : "NO");
-
-    ec_point_clear(&R_point);
-    ec_point_clear(&temp1);
-    ec_point_clear(&temp2);
-    mpz_clears(a_value, e, v, z1, z2, temp, NULL);
-    return valid;
-}
+#include "gost3410.h"
+#include "../hash/stribog.h"    // Предполагается, что здесь объявлены init() и stribog()
+#include "../hash/types.h"      // Определения u8, u64 и т.п.
+#include "../ec/ec_point.h"
+#include "../ec/ec_table.h"
+#include "gost_rand.h"
+#include "gost_rfc6979.h"
+#include "gost_workspace.h"
+#include <gmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define BLOCK_SIZE 64
+#define GREEN   "\033[0;32m"
+#define RED     "\033[0;31m"
+#define RESET   "\033[0m"
+
+/* Преобразование хэша длиной len байт в число mpz_t */
+static void hash_to_mpz(mpz_t out, const unsigned char *hash, size_t len) {
+    mpz_import(out, len, 1, sizeof(unsigned char), 0, 0, hash);
+}
+
+/* Размер хэша для порядка q: по ГОСТ 34.10–2018 для q < 2^256 используется
+   256-битный Стрибог, для 512-битных кривых — 512-битный. Для кривых с
+   контекстом он уже посчитан: gost_curve_t.hash_size. */
+static int gost3410_hash_size(const mpz_t q) {
+    return mpz_sizeinbase(q, 2) > 256 ? HASH512 : HASH256;
+}
+
+/* Хэш сообщения в h (число в записи стандарта, старший байт первым); size —
+   HASH256 или HASH512. Возвращает длину хэша в байтах. */
+static size_t gost3410_digest(unsigned char *h, const unsigned char *message, size_t message_len,
+                              int size) {
+    struct stribog_ctx_t ctx;
+    size_t n = size == HASH512 ? OUTPUT_SIZE_512 : OUTPUT_SIZE_256;
+    init(&ctx, size);
+    stribog(&ctx, (u8 *)message, (u64)message_len);
+    // Для 256-битного хэша результат — первые 32 байта ctx.h
+    memcpy(h, ctx.h, n);
+    return n;
+}
+
+/* Контекст скаляров по модулю q для функций, которым не передан контекст
+   кривой (в нём он уже построен: gost_curve_t.Fq) */
+static int gost3410_scalar_ctx(fp_ctx_t *Fq, const mpz_t q) {
+    if (fp_ctx_init(Fq, q) != 0)
+        return -1;
+    Fq->ct = 1;
+    return 0;
+}
+
+/* e = h mod q (e = 1, если остаток нулевой); h — число, старший байт первым */
+static void gost3410_scalar_e(const fp_ctx_t *Fq, fp_t *e, const unsigned char *h, size_t len) {
+    mp_limb_t t[FP_MAX_LIMBS] = {0};
+
+    if (len <= (size_t)Fq->n * sizeof(mp_limb_t)) {
+        for (size_t i = 0; i < len; i++)
+            t[i / sizeof(mp_limb_t)] |= (mp_limb_t)h[len - 1 - i] << (8 * (i % sizeof(mp_limb_t)));
+        fp_from_limbs(Fq, e, t, Fq->n);
+    } else {
+        // Хэш длиннее q (пользовательская кривая с малым q)
+        mpz_t z;
+        mpz_init(z);
+        hash_to_mpz(z, h, len);
+        fp_from_mpz(Fq, e, z);
+        mpz_clear(z);
+    }
+    if (fp_is_zero(Fq, e))
+        fp_set_ui(Fq, e, 1);
+}
+
+/* r = x mod q для координаты точки: если x не длиннее q, без mpz_mod */
+static void gost3410_scalar_x(const fp_ctx_t *Fq, fp_t *r, const mpz_t x) {
+    if ((mp_size_t)mpz_size(x) <= Fq->n)
+        fp_from_limbs(Fq, r, mpz_limbs_read(x), (mp_size_t)mpz_size(x));
+    else
+        fp_from_mpz(Fq, r, x);
+}
+
+/* Завершение подписи: r = x mod q, s = r*d + k*e mod q (одна редукция).
+   Возвращает 0 при вырожденных r = 0 или s = 0 (r, s тогда не записываются). */
+static int gost3410_scalar_s(const fp_ctx_t *Fq, mpz_t r, mpz_t s, const mpz_t x,
+                             const fp_t *d, const mpz_t k, const fp_t *e) {
+    fp_t fr, fk, fs;
+    int ok;
+
+    gost3410_scalar_x(Fq, &fr, x);
+    fp_from_mpz(Fq, &fk, k);
+    fp_mul_add(Fq, &fs, &fr, d, &fk, e);
+    ok = !fp_is_zero(Fq, &fr) && !fp_is_zero(Fq, &fs);
+    if (ok) {
+        fp_to_mpz(Fq, r, &fr);
+        fp_to_mpz(Fq, s, &fs);
+    }
+    memset(&fk, 0, sizeof(fk));
+    return ok;
+}
+
+/* Одноразовое число k из [1, q-1]; без источника энтропии подписывать нельзя */
+static void gost3410_nonce(mpz_t k, const mpz_t q) {
+    if (gost_rand_scalar(k, q) != 0) {
+        fprintf(stderr, "Error: no system entropy source for nonce generation\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Контекст скаляров по модулю q не задан (Fq == NULL) — строится на стеке */
+static void gost3410_sign_scalar_ctx(fp_ctx_t *Fl, const mpz_t q) {
+    if (gost3410_scalar_ctx(Fl, q) != 0) {
+        fprintf(stderr, "Error: unsupported subgroup order q\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Общая часть формирования подписи по хэшу h: k*P считается по таблице T, если
+   она задана; при det одноразовые числа выводятся из d и хэша по RFC 6979.
+   Скаляры по модулю q — в контексте Fq (NULL — построить по q), временные
+   mpz_t и точка — в рабочей области W (NULL — выделить на время вызова). */
+static void gost3410_sign_hash(mpz_t r, mpz_t s,
+                               const unsigned char *h, size_t hlen,
+                               const mpz_t d, const mpz_t q,
+                               const mpz_t p, const mpz_t a,
+                               const EC_Point *P, const ec_table_t *T, int det,
+                               const fp_ctx_t *Fq, gost_workspace_t *W) {
+    gost_rfc6979_t G;
+    gost_workspace_t Wl;
+    fp_ctx_t Fl;
+    fp_t e, fd;
+
+    if (!Fq) {
+        gost3410_sign_scalar_ctx(&Fl, q);
+        Fq = &Fl;
+    }
+    if (!W) {
+        gost_workspace_init(&Wl);
+        W = &Wl;
+    }
+    gost3410_scalar_e(Fq, &e, h, hlen);
+    fp_from_mpz(Fq, &fd, d);
+    if (det)
+        gost_rfc6979_init(&G, q, d, h, hlen, hlen == OUTPUT_SIZE_512 ? HASH512 : HASH256);
+
+    while (1) {
+        if (det)
+            gost_rfc6979_next(&G, W->k, q);
+        else
+            gost3410_nonce(W->k, q);
+        // k секретно: умножение за время, не зависящее от k
+        if (T)
+            ec_point_mul_table_ct(&W->R, W->k, T);
+        else
+            ec_point_mul_ct(&W->R, W->k, P, p, a, mpz_sizeinbase(q, 2));
+        if (W->R.infinity)
+            continue;
+        if (gost3410_scalar_s(Fq, r, s, W->R.x, &fd, W->k, &e))
+            break;
+    }
+
+    //gmp_printf(GREEN "k = %Zx\n" RESET, W->k);
+    //gmp_printf(GREEN "r = %Zx\n" RESET, r);
+    //gmp_printf(GREEN "s = %Zx\n" RESET, s);
+
+    if (det)
+        gost_rfc6979_clear(&G);
+    gost_workspace_wipe(W);
+    if (W == &Wl)
+        gost_workspace_clear(&Wl);
+    memset(&fd, 0, sizeof(fd));
+}
+
+/* k*P для одноразового числа, считаемое вторым потоком во время хэширования */
+typedef struct {
+    mpz_srcptr k, q, p, a;
+    const EC_Point *P;
+    const ec_table_t *T;
+    EC_Point C;
+} gost3410_nonce_job_t;
+
+static void *gost3410_nonce_worker(void *arg) {
+    gost3410_nonce_job_t *job = (gost3410_nonce_job_t *)arg;
+
+    if (job->T)
+        ec_point_mul_table_ct(&job->C, job->k, job->T);
+    else
+        ec_point_mul_ct(&job->C, job->k, job->P, job->p, job->a, mpz_sizeinbase(job->q, 2));
+    return NULL;
+}
+
+/* Параллельное хэширование имеет смысл, только если процессоров больше одного */
+static long gost3410_cpus = 1;
+static pthread_once_t gost3410_cpus_once = PTHREAD_ONCE_INIT;
+
+static void gost3410_cpus_init(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    gost3410_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    gost3410_cpus = 2;
+#endif
+}
+
+/* Хэширование сообщения и подпись. Для сообщений от GOST3410_OVERLAP_MIN байт
+   со случайным k (k от сообщения не зависит) k*P считается вторым потоком
+   одновременно с хэшем (на однопроцессорной машине — как обычно); k
+   выбирается заранее в вызывающем потоке, чтобы короткоживущий поток не
+   засевал свой генератор. */
+static void gost3410_sign_internal(mpz_t r, mpz_t s,
+                                   const unsigned char *message, size_t message_len,
+                                   const mpz_t d, const mpz_t q, int size,
+                                   const mpz_t p, const mpz_t a,
+                                   const EC_Point *P, const ec_table_t *T, int det,
+                                   const fp_ctx_t *Fq) {
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen;
+    gost3410_nonce_job_t job;
+    pthread_t tid;
+    fp_ctx_t Fl;
+    fp_t e, fd;
+    mpz_t k;
+    int done = 0;
+
+    if (!det && message_len >= GOST3410_OVERLAP_MIN)
+        pthread_once(&gost3410_cpus_once, gost3410_cpus_init);
+    if (det || message_len < GOST3410_OVERLAP_MIN || gost3410_cpus < 2) {
+        hlen = gost3410_digest(h, message, message_len, size);
+        gost3410_sign_hash(r, s, h, hlen, d, q, p, a, P, T, det, Fq, NULL);
+        return;
+    }
+
+    if (!Fq) {
+        gost3410_sign_scalar_ctx(&Fl, q);
+        Fq = &Fl;
+    }
+    mpz_init(k);
+    gost3410_nonce(k, q);
+    job.k = k;
+    job.q = q;
+    job.p = p;
+    job.a = a;
+    job.P = P;
+    job.T = T;
+    ec_point_init(&job.C);
+    if (pthread_create(&tid, NULL, gost3410_nonce_worker, &job) == 0) {
+        hlen = gost3410_digest(h, message, message_len, size);
+        pthread_join(tid, NULL);
+    } else {
+        hlen = gost3410_digest(h, message, message_len, size);
+        gost3410_nonce_worker(&job);
+    }
+
+    // Вырожденные r = 0 или s = 0 — обычная подпись по уже готовому хэшу
+    gost3410_scalar_e(Fq, &e, h, hlen);
+    fp_from_mpz(Fq, &fd, d);
+    if (!job.C.infinity)
+        done = gost3410_scalar_s(Fq, r, s, job.C.x, &fd, k, &e);
+    if (!done)
+        gost3410_sign_hash(r, s, h, hlen, d, q, p, a, P, T, 0, Fq, NULL);
+
+    mpz_set_ui(k, 0);
+    memset(&fd, 0, sizeof(fd));
+    ec_point_clear(&job.C);
+    mpz_clear(k);
+}
+
+/* Формирование подписи по ГОСТ 34.10–2018 */
+void gost3410_sign(mpz_t r, mpz_t s,
+                   const unsigned char *message, size_t message_len,
+                   const mpz_t d, const mpz_t q,
+                   const mpz_t p, const mpz_t a,
+                   const EC_Point *P) {
+    gost3410_sign_internal(r, s, message, message_len, d, q, gost3410_hash_size(q), p, a, P, NULL, 0, NULL);
+}
+
+/* Формирование подписи с таблицей фиксированной базы */
+void gost3410_sign_table(mpz_t r, mpz_t s,
+                         const unsigned char *message, size_t message_len,
+                         const mpz_t d, const mpz_t q,
+                         const ec_table_t *T) {
+    gost3410_sign_internal(r, s, message, message_len, d, q, gost3410_hash_size(q), NULL, NULL, NULL, T, 0, NULL);
+}
+
+/* Формирование подписи на контексте кривой */
+void gost3410_sign_curve(mpz_t r, mpz_t s,
+                         const unsigned char *message, size_t message_len,
+                         const mpz_t d, const gost_curve_t *C) {
+    gost3410_sign_internal(r, s, message, message_len, d, C->q, C->hash_size, NULL, NULL, NULL, &C->T, 0, &C->Fq);
+}
+
+/* Формирование подписи с рабочей областью вызывающего потока: без второго
+   потока для длинных сообщений, чтобы не выделять память на его создание */
+void gost3410_sign_curve_ws(mpz_t r, mpz_t s,
+                            const unsigned char *message, size_t message_len,
+                            const mpz_t d, const gost_curve_t *C, gost_workspace_t *W) {
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen = gost3410_digest(h, message, message_len, C->hash_size);
+    gost3410_sign_hash(r, s, h, hlen, d, C->q, NULL, NULL, NULL, &C->T, 0, &C->Fq, W);
+}
+
+/* Формирование подписи с детерминированным одноразовым числом */
+void gost3410_sign_curve_det(mpz_t r, mpz_t s,
+                             const unsigned char *message, size_t message_len,
+                             const mpz_t d, const gost_curve_t *C) {
+    gost3410_sign_internal(r, s, message, message_len, d, C->q, C->hash_size, NULL, NULL, NULL, &C->T, 1, &C->Fq);
+}
+
+/* Формирование подписи с парой из пула предподписей; пустой пул — обычная подпись */
+void gost3410_sign_presig(mpz_t r, mpz_t s,
+                          const unsigned char *message, size_t message_len,
+                          const mpz_t d, gost_presig_t *pool) {
+    const gost_curve_t *C = pool->C;
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen = gost3410_digest(h, message, message_len, C->hash_size);
+    fp_t e, fd;
+    mpz_t k;
+    int done = 0;
+
+    mpz_init(k);
+    gost3410_scalar_e(&C->Fq, &e, h, hlen);
+    fp_from_mpz(&C->Fq, &fd, d);
+    while (!done && gost_presig_take(pool, k, r))
+        done = gost3410_scalar_s(&C->Fq, r, s, r, &fd, k, &e);
+    if (!done)
+        gost3410_sign_hash(r, s, h, hlen, d, C->q, NULL, NULL, NULL, &C->T, 0, &C->Fq, NULL);
+    mpz_set_ui(k, 0);
+    memset(&fd, 0, sizeof(fd));
+    mpz_clear(k);
+}
+
+/* Хэш сообщения для кривой C, как его ждут функции подписи и проверки по хэшу */
+size_t gost3410_hash(unsigned char *h, const unsigned char *message, size_t message_len,
+                     const gost_curve_t *C) {
+    return gost3410_digest(h, message, message_len, C->hash_size);
+}
+
+/* Хэш в порядке строки байт RFC 7836 в запись стандарта: порядок байт
+   обращается, поэтому допускается h == digest */
+void gost3410_digest_from_rfc(unsigned char *h, const unsigned char *digest, size_t len) {
+    for (size_t i = 0, j = len; i < j--; i++) {
+        unsigned char t = digest[i];
+        h[i] = digest[j];
+        h[j] = t;
+    }
+}
+
+/* Длина хэша, соответствующая кривой C */
+static size_t gost3410_hash_len(const gost_curve_t *C) {
+    return C->hash_size == HASH512 ? OUTPUT_SIZE_512 : OUTPUT_SIZE_256;
+}
+
+/* Формирование подписи по готовому хэшу */
+int gost3410_sign_digest(mpz_t r, mpz_t s,
+                         const unsigned char *digest, size_t digest_len,
+                         const mpz_t d, const gost_curve_t *C) {
+    if (digest_len != gost3410_hash_len(C))
+        return -1;
+    gost3410_sign_hash(r, s, digest, digest_len, d, C->q, NULL, NULL, NULL, &C->T, 0, &C->Fq, NULL);
+    return 0;
+}
+
+/* Генерация пары ключей */
+int gost3410_keygen(mpz_t d, EC_Point *Q, const gost_curve_t *C) {
+    if (gost_rand_scalar(d, C->q) != 0)
+        return -1;
+    ec_point_mul_table_ct(Q, d, &C->T);
+    return 0;
+}
+
+/* Часть пакета, обрабатываемая одним потоком: элементы [begin, end) */
+typedef struct {
+    const gost_curve_t *C;
+    const unsigned char *const *messages;
+    const size_t *message_lens;
+    mpz_t *r, *s;
+    mpz_srcptr d;                   // подпись: закрытый ключ
+    mpz_t *k;                       // подпись: одноразовые числа
+    const EC_Point *const *Q;       // проверка: открытые ключи
+    int *valid;                     // проверка: результаты по элементам
+    size_t begin, end;
+    int status;
+} gost3410_batch_job_t;
+
+/* Разбиение [0, n) на nthreads частей и выполнение worker для каждой;
+   первая часть выполняется в вызывающем потоке. Возвращает 0, если все
+   части завершились успешно. */
+static int gost3410_run_batch(void *(*worker)(void *), const gost3410_batch_job_t *base,
+                              size_t n, int nthreads) {
+    gost3410_batch_job_t *jobs;
+    pthread_t *tids;
+    size_t nt, started = 0;
+    int ret = 0;
+
+    nt = nthreads > 1 ? (size_t)nthreads : 1;
+    if (nt > n)
+        nt = n;
+    jobs = (gost3410_batch_job_t *)malloc(nt * sizeof(*jobs));
+    tids = (pthread_t *)malloc(nt * sizeof(*tids));
+    if (!jobs || !tids) {
+        free(jobs);
+        free(tids);
+        return -1;
+    }
+
+    for (size_t t = 0; t < nt; t++) {
+        jobs[t] = *base;
+        jobs[t].begin = n * t / nt;
+        jobs[t].end = n * (t + 1) / nt;
+        jobs[t].status = -1;
+    }
+    for (size_t t = 1; t < nt; t++, started++) {
+        if (pthread_create(&tids[t], NULL, worker, &jobs[t]) != 0)
+            break;
+    }
+    worker(&jobs[0]);
+    // Части, для которых поток не удалось создать, выполняются здесь же
+    for (size_t t = started + 1; t < nt; t++)
+        worker(&jobs[t]);
+    for (size_t t = 1; t <= started; t++)
+        pthread_join(tids[t], NULL);
+
+    for (size_t t = 0; t < nt; t++)
+        if (jobs[t].status != 0)
+            ret = -1;
+    free(jobs);
+    free(tids);
+    return ret;
+}
+
+/* Все k_i*P считаются по таблице в якобиевых координатах и переводятся
+   в аффинные одним обращением на всю часть пакета */
+static void *gost3410_sign_batch_worker(void *arg) {
+    gost3410_batch_job_t *job = (gost3410_batch_job_t *)arg;
+    const gost_curve_t *C = job->C;
+    size_t n = job->end - job->begin;
+    ec_jpoint_t *J = (ec_jpoint_t *)malloc(n * sizeof(ec_jpoint_t));
+    ec_apoint_t *A = (ec_apoint_t *)malloc(n * sizeof(ec_apoint_t));
+    fp_t e, fd;
+    mpz_t x;
+
+    if (n == 0 || !J || !A) {
+        free(J);
+        free(A);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++)
+        ec_jpoint_mul_table_ct(&C->T, &J[i], job->k[job->begin + i]);
+    ec_points_normalize_batch(&C->T.E, A, J, n);
+
+    fp_from_mpz(&C->Fq, &fd, job->d);
+    mpz_init(x);
+    for (size_t i = 0; i < n; i++) {
+        size_t idx = job->begin + i;
+        unsigned char h[OUTPUT_SIZE_512];
+        size_t hlen = gost3410_digest(h, job->messages[idx], job->message_lens[idx], C->hash_size);
+        int done = 0;
+
+        gost3410_scalar_e(&C->Fq, &e, h, hlen);
+        if (!A[i].infinity) {
+            fp_to_mpz(&C->T.E.F, x, &A[i].x);
+            done = gost3410_scalar_s(&C->Fq, job->r[idx], job->s[idx], x, &fd, job->k[idx], &e);
+        }
+        // Вырожденные случаи (r = 0 или s = 0) практически не встречаются: подписываем заново
+        if (!done)
+            gost3410_sign_hash(job->r[idx], job->s[idx], h, hlen, job->d, C->q,
+                               NULL, NULL, NULL, &C->T, 0, &C->Fq, NULL);
+    }
+    memset(&fd, 0, sizeof(fd));
+    mpz_clear(x);
+
+    free(J);
+    free(A);
+    job->status = 0;
+    return NULL;
+}
+
+/* Пакетное формирование подписей одним ключом */
+int gost3410_sign_batch(mpz_t r[], mpz_t s[],
+                        const unsigned char *const messages[], const size_t message_lens[],
+                        size_t n, const mpz_t d, const gost_curve_t *C, int nthreads) {
+    gost3410_batch_job_t job;
+    mpz_t *k;
+    int ret = 0;
+
+    if (n == 0)
+        return 0;
+    k = (mpz_t *)malloc(n * sizeof(mpz_t));
+    if (!k)
+        return -1;
+
+    // Одноразовые числа выбираются заранее в вызывающем потоке
+    for (size_t i = 0; i < n; i++) {
+        mpz_init(k[i]);
+        if (ret == 0 && gost_rand_scalar(k[i], C->q) != 0)
+            ret = -1;
+    }
+    if (ret != 0)
+        goto done;
+
+    memset(&job, 0, sizeof(job));
+    job.C = C;
+    job.messages = messages;
+    job.message_lens = message_lens;
+    job.r = r;
+    job.s = s;
+    job.d = d;
+    job.k = k;
+    ret = gost3410_run_batch(gost3410_sign_batch_worker, &job, n, nthreads);
+
+done:
+    for (size_t i = 0; i < n; i++)
+        mpz_clear(k[i]);
+    free(k);
+    return ret;
+}
+
+/* Проверка x(V) = r (mod q) без перехода к аффинным координатам:
+   X сравнивается с x*Z^2 для всех кандидатов x = r + j*q < p */
+static int gost3410_check_x(const gost_curve_t *C, const ec_jpoint_t *V, const mpz_t r) {
+    const fp_ctx_t *F = &C->T.E.F;
+    fp_t z2, t;
+    mpz_t x;
+    int ok = 0;
+
+    if (ec_jpoint_is_infinity(&C->T.E, V))
+        return 0;
+    fp_sqr(F, &z2, &V->Z);
+    mpz_init_set(x, r);
+    for (; !ok && mpz_cmp(x, C->p) < 0; mpz_add(x, x, C->q)) {
+        fp_from_mpz(F, &t, x);
+        fp_mul(F, &t, &t, &z2);
+        ok = fp_equal(F, &t, &V->X);
+    }
+    mpz_clear(x);
+    return ok;
+}
+
+/* Проверка части пакета. Обратные к e_i по модулю q считаются приёмом
+   Монтгомери (одно обращение на часть), z1*P — по таблице, результат
+   сравнивается с r без обращения координаты Z. */
+static void *gost3410_verify_batch_worker(void *arg) {
+    gost3410_batch_job_t *job = (gost3410_batch_job_t *)arg;
+    const gost_curve_t *C = job->C;
+    const ec_ctx_t *E = &C->T.E;
+    const fp_ctx_t *Fq = &C->Fq;
+    size_t n = job->end - job->begin;
+    fp_t *e = (fp_t *)malloc(n * sizeof(fp_t));
+    fp_t *c = (fp_t *)malloc(n * sizeof(fp_t));
+    fp_t inv, v, fr, fs;
+    mpz_t z1, z2;
+    ec_jpoint_t V, W;
+    ec_apoint_t A;
+
+    if (n == 0 || !e || !c) {
+        free(e);
+        free(c);
+        return NULL;
+    }
+
+    // c_i = e_0 * ... * e_i mod q
+    for (size_t i = 0; i < n; i++) {
+        size_t idx = job->begin + i;
+        unsigned char h[OUTPUT_SIZE_512];
+        size_t hlen = gost3410_digest(h, job->messages[idx], job->message_lens[idx], C->hash_size);
+
+        gost3410_scalar_e(Fq, &e[i], h, hlen);
+        if (i == 0)
+            fp_copy(Fq, &c[i], &e[i]);
+        else
+            fp_mul(Fq, &c[i], &c[i - 1], &e[i]);
+    }
+
+    mpz_inits(z1, z2, NULL);
+    fp_inv(Fq, &inv, &c[n - 1]);
+    for (size_t i = n; i-- > 0;) {
+        size_t idx = job->begin + i;
+        mpz_srcptr r = job->r[idx], s = job->s[idx];
+
+        // inv = (e_0 * ... * e_i)^{-1}; v = e_i^{-1} = inv * c_{i-1}
+        if (i > 0) {
+            fp_mul(Fq, &v, &inv, &c[i - 1]);
+            fp_mul(Fq, &inv, &inv, &e[i]);
+        } else {
+            fp_copy(Fq, &v, &inv);
+        }
+
+        if (mpz_sgn(r) <= 0 || mpz_cmp(r, C->q) >= 0 ||
+            mpz_sgn(s) <= 0 || mpz_cmp(s, C->q) >= 0 || job->Q[idx]->infinity) {
+            job->valid[idx] = 0;
+            continue;
+        }
+        fp_from_mpz(Fq, &fr, r);
+        fp_from_mpz(Fq, &fs, s);
+        fp_mul(Fq, &fs, &fs, &v);
+        fp_mul(Fq, &fr, &fr, &v);
+        fp_neg(Fq, &fr, &fr);
+        fp_to_mpz(Fq, z1, &fs);
+        fp_to_mpz(Fq, z2, &fr);
+
+        ec_jpoint_mul_table(&C->T, &V, z1);
+        ec_apoint_from_point(E, &A, job->Q[idx]);
+        ec_jpoint_mul(E, &W, z2, &A);
+        ec_jpoint_add(E, &V, &V, &W);
+        job->valid[idx] = gost3410_check_x(C, &V, r);
+    }
+    mpz_clears(z1, z2, NULL);
+
+    free(e);
+    free(c);
+    job->status = 0;
+    return NULL;
+}
+
+/* Пакетная проверка подписей */
+int gost3410_verify_batch(int valid[],
+                          const unsigned char *const messages[], const size_t message_lens[],
+                          mpz_t r[], mpz_t s[], const EC_Point *const Q[],
+                          size_t n, const gost_curve_t *C, int nthreads) {
+    gost3410_batch_job_t job;
+    int *res = valid;
+    int all = 1;
+
+    if (n == 0)
+        return 1;
+    if (!res && !(res = (int *)malloc(n * sizeof(int))))
+        return -1;
+
+    memset(&job, 0, sizeof(job));
+    job.C = C;
+    job.messages = messages;
+    job.message_lens = message_lens;
+    job.r = r;
+    job.s = s;
+    job.Q = Q;
+    job.valid = res;
+    if (gost3410_run_batch(gost3410_verify_batch_worker, &job, n, nthreads) != 0) {
+        all = -1;
+    } else {
+        for (size_t i = 0; i < n; i++)
+            all &= res[i];
+    }
+
+    if (res != valid)
+        free(res);
+    return all;
+}
+
+/* z2*Q для проверки с разделением: по таблице ключа TQ или обычным умножением */
+typedef struct {
+    const ec_table_t *T, *TQ;
+    const ec_apoint_t *Q;
+    mpz_srcptr k;
+    ec_jpoint_t R;
+} gost3410_mul_job_t;
+
+static void gost3410_mul_job(void *arg) {
+    gost3410_mul_job_t *job = (gost3410_mul_job_t *)arg;
+
+    if (job->TQ)
+        ec_jpoint_mul_table(job->TQ, &job->R, job->k);
+    else
+        ec_jpoint_mul(&job->T->E, &job->R, job->k, job->Q);
+}
+
+/* R = z1*P + z2*Q, где z2*Q считает помощник из H, а z1*P по таблице T —
+   вызывающий поток; если свободного помощника нет, оба умножения здесь же */
+static void gost3410_mul_add_split(EC_Point *R, const mpz_t z1, const ec_table_t *T,
+                                   const mpz_t z2, const EC_Point *Q, const ec_table_t *TQ,
+                                   gost_helper_pool_t *H) {
+    gost3410_mul_job_t job;
+    gost_helper_t *W;
+    ec_apoint_t A;
+    ec_jpoint_t J;
+
+    job.T = T;
+    job.TQ = TQ;
+    job.Q = &A;
+    job.k = z2;
+    if (!TQ)
+        ec_apoint_from_point(&T->E, &A, Q);
+    W = gost_helper_submit(H, gost3410_mul_job, &job);
+    ec_jpoint_mul_table(T, &J, z1);
+    if (W)
+        gost_helper_wait(W);
+    else
+        gost3410_mul_job(&job);
+
+    ec_jpoint_add(&T->E, &J, &J, &job.R);
+    ec_jpoint_to_apoint(&T->E, &A, &J);
+    ec_apoint_to_point(&T->E, R, &A);
+}
+
+/* Общая часть проверки подписи по хэшу h */
+static int gost3410_verify_hash(const unsigned char *h, size_t hlen,
+                                const mpz_t r, const mpz_t s,
+                                const EC_Point *Q,
+                                const mpz_t q, const mpz_t p, const mpz_t a,
+                                const EC_Point *P, const ec_table_t *T,
+                                const ec_table_t *TQ, gost_helper_pool_t *H,
+                                const fp_ctx_t *Fq, gost_workspace_t *W) {
+    gost_workspace_t Wl;
+    fp_ctx_t Fl;
+    fp_t e, v, fr, fs;
+
+    if (mpz_cmp_ui(r, 0) <= 0 || mpz_cmp(r, q) >= 0 ||
+        mpz_cmp_ui(s, 0) <= 0 || mpz_cmp(s, q) >= 0)
+        return 0;
+    if (!Fq) {
+        if (gost3410_scalar_ctx(&Fl, q) != 0)
+            return 0;
+        Fq = &Fl;
+    }
+
+    gost3410_scalar_e(Fq, &e, h, hlen);
+    fp_inv(Fq, &v, &e);
+    if (fp_is_zero(Fq, &v)) {
+        //printf(RED "=== DEBUG: Inverse of e does not exist! ===\n" RESET);
+        return 0;
+    }
+
+    // z1 = s*v, z2 = -r*v
+    fp_from_mpz(Fq, &fr, r);
+    fp_from_mpz(Fq, &fs, s);
+    fp_mul(Fq, &fs, &fs, &v);
+    fp_mul(Fq, &v, &fr, &v);
+    fp_neg(Fq, &v, &v);
+
+    if (!W) {
+        gost_workspace_init(&Wl);
+        W = &Wl;
+    }
+    fp_to_mpz(Fq, W->z1, &fs);
+    fp_to_mpz(Fq, W->z2, &v);
+
+    //gmp_printf(RED "z1 = %Zx\n" RESET, W->z1);
+    //gmp_printf(RED "z2 = %Zx\n\n" RESET, W->z2);
+
+    if (T && H)
+        gost3410_mul_add_split(&W->R, W->z1, T, W->z2, Q, TQ, H);
+    else if (T && TQ)
+        ec_point_mul2_table(&W->R, W->z1, T, W->z2, TQ);
+    else if (T)
+        ec_point_mul_add_table(&W->R, W->z1, T, W->z2, Q);
+    else
+        ec_point_mul_add(&W->R, W->z1, P, W->z2, Q, p, a);
+    // Бесконечность: x = 0 не совпадёт с r > 0
+    if (W->R.infinity)
+        fp_set_ui(Fq, &v, 0);
+    else
+        gost3410_scalar_x(Fq, &v, W->R.x);
+
+    int valid = fp_equal(Fq, &v, &fr);
+    //printf(RED "=== DEBUG: Signature VALID? %s ===\n" RESET, valid ? "YES" : "NO");
+
+    if (W == &Wl)
+        gost_workspace_clear(&Wl);
+    return valid;
+}
+
+static int gost3410_verify_internal(const unsigned char *message, size_t message_len,
+                                    const mpz_t r, const mpz_t s,
+                                    const EC_Point *Q,
+                                    const mpz_t q, int size, const mpz_t p, const mpz_t a,
+                                    const EC_Point *P, const ec_table_t *T,
+                                    const ec_table_t *TQ, gost_helper_pool_t *H,
+                                    const fp_ctx_t *Fq, gost_workspace_t *W) {
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen = gost3410_digest(h, message, message_len, size);
+    return gost3410_verify_hash(h, hlen, r, s, Q, q, p, a, P, T, TQ, H, Fq, W);
+}
+
+/* Проверка подписи по ГОСТ 34.10–2018 */
+int gost3410_verify(const unsigned char *message, size_t message_len,
+                    const mpz_t r, const mpz_t s,
+                    const EC_Point *Q,
+                    const mpz_t q, const mpz_t p, const mpz_t a,
+                    const EC_Point *P) {
+    return gost3410_verify_internal(message, message_len, r, s, Q, q, gost3410_hash_size(q), p, a, P, NULL, NULL, NULL, NULL, NULL);
+}
+
+/* Проверка подписи с таблицей фиксированной базы */
+int gost3410_verify_table(const unsigned char *message, size_t message_len,
+                          const mpz_t r, const mpz_t s,
+                          const EC_Point *Q, const mpz_t q,
+                          const ec_table_t *T) {
+    return gost3410_verify_internal(message, message_len, r, s, Q, q, gost3410_hash_size(q), NULL, NULL, NULL, T, NULL, NULL, NULL, NULL);
+}
+
+/* Проверка подписи на контексте кривой */
+int gost3410_verify_curve(const unsigned char *message, size_t message_len,
+                          const mpz_t r, const mpz_t s,
+                          const EC_Point *Q, const gost_curve_t *C) {
+    return gost3410_verify_internal(message, message_len, r, s, Q, C->q, C->hash_size, NULL, NULL, NULL, &C->T, NULL, NULL, &C->Fq, NULL);
+}
+
+/* Проверка подписи с рабочей областью вызывающего потока */
+int gost3410_verify_curve_ws(const unsigned char *message, size_t message_len,
+                             const mpz_t r, const mpz_t s,
+                             const EC_Point *Q, const gost_curve_t *C, gost_workspace_t *W) {
+    return gost3410_verify_internal(message, message_len, r, s, Q, C->q, C->hash_size, NULL, NULL, NULL, &C->T, NULL, NULL, &C->Fq, W);
+}
+
+/* Проверка подписи на контексте кривой с таблицей открытого ключа */
+int gost3410_verify_curve_key(const unsigned char *message, size_t message_len,
+                              const mpz_t r, const mpz_t s,
+                              const ec_table_t *TQ, const gost_curve_t *C) {
+    return gost3410_verify_internal(message, message_len, r, s, NULL, C->q, C->hash_size, NULL, NULL, NULL, &C->T, TQ, NULL, &C->Fq, NULL);
+}
+
+/* Проверка с разделением умножений между вызывающим потоком и помощником */
+int gost3410_verify_curve_split(const unsigned char *message, size_t message_len,
+                                const mpz_t r, const mpz_t s,
+                                const EC_Point *Q, const gost_curve_t *C,
+                                gost_helper_pool_t *H) {
+    return gost3410_verify_internal(message, message_len, r, s, Q, C->q, C->hash_size, NULL, NULL, NULL, &C->T, NULL, H, &C->Fq, NULL);
+}
+
+int gost3410_verify_curve_key_split(const unsigned char *message, size_t message_len,
+                                    const mpz_t r, const mpz_t s,
+                                    const ec_table_t *TQ, const gost_curve_t *C,
+                                    gost_helper_pool_t *H) {
+    return gost3410_verify_internal(message, message_len, r, s, NULL, C->q, C->hash_size, NULL, NULL, NULL, &C->T, TQ, H, &C->Fq, NULL);
+}
+
+/* Проверка подписи по готовому хэшу */
+int gost3410_verify_digest(const unsigned char *digest, size_t digest_len,
+                           const mpz_t r, const mpz_t s,
+                           const EC_Point *Q, const gost_curve_t *C) {
+    if (digest_len != gost3410_hash_len(C))
+        return 0;
+    return gost3410_verify_hash(digest, digest_len, r, s, Q, C->q, NULL, NULL, NULL, &C->T, NULL, NULL, &C->Fq, NULL);
+}
+
+/* Хэш потока в записи стандарта: результат hmac_stribog_hash_final
+   в порядке строки байт переставляется */
+size_t gost3410_stream_digest(unsigned char *h, hmac_stribog_hash_t *H) {
+    size_t n = hmac_stribog_size(H->size);
+
+    hmac_stribog_hash_final(H, h);
+    gost3410_digest_from_rfc(h, h, n);
+    memset(H, 0, sizeof(*H));
+    return n;
+}
+
+/* Случайное k и r = (k*P).x mod q для потоковой подписи */
+static void gost3410_sign_prepare(gost3410_sign_ctx_t *ctx) {
+    const gost_curve_t *C = ctx->C;
+    EC_Point R;
+
+    ec_point_init(&R);
+    gost3410_nonce(ctx->k, C->q);
+    ec_point_mul_table_ct(&R, ctx->k, &C->T);
+    if (!R.infinity) {
+        fp_t x;
+        gost3410_scalar_x(&C->Fq, &x, R.x);
+        fp_to_mpz(&C->Fq, ctx->r, &x);
+    } else {
+        mpz_set_ui(ctx->r, 0);
+    }
+    ec_point_clear(&R);
+    ctx->ready = 1;
+}
+
+void gost3410_sign_init(gost3410_sign_ctx_t *ctx, const mpz_t d, const gost_curve_t *C) {
+    ctx->C = C;
+    hmac_stribog_hash_init(&ctx->H, C->hash_size);
+    mpz_init_set(ctx->d, d);
+    mpz_inits(ctx->k, ctx->r, NULL);
+    ctx->ready = 0;
+}
+
+void gost3410_sign_update(gost3410_sign_ctx_t *ctx, const unsigned char *data, size_t len) {
+    if (!ctx->ready)
+        gost3410_sign_prepare(ctx);
+    hmac_stribog_hash_update(&ctx->H, data, len);
+}
+
+void gost3410_sign_final(gost3410_sign_ctx_t *ctx, mpz_t r, mpz_t s) {
+    const gost_curve_t *C = ctx->C;
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen = gost3410_stream_digest(h, &ctx->H);
+    fp_t e, fd;
+    int done = 0;
+
+    if (!ctx->ready)
+        gost3410_sign_prepare(ctx);
+    gost3410_scalar_e(&C->Fq, &e, h, hlen);
+    fp_from_mpz(&C->Fq, &fd, ctx->d);
+    // Вырожденные r = 0 или s = 0 — обычная подпись по готовому хэшу
+    if (mpz_sgn(ctx->r) != 0)
+        done = gost3410_scalar_s(&C->Fq, r, s, ctx->r, &fd, ctx->k, &e);
+    if (!done)
+        gost3410_sign_hash(r, s, h, hlen, ctx->d, C->q, NULL, NULL, NULL, &C->T, 0, &C->Fq, NULL);
+
+    mpz_set_ui(ctx->d, 0);
+    mpz_set_ui(ctx->k, 0);
+    memset(&fd, 0, sizeof(fd));
+    mpz_clears(ctx->d, ctx->k, ctx->r, NULL);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void gost3410_verify_init(gost3410_verify_ctx_t *ctx, const EC_Point *Q, const gost_curve_t *C) {
+    ctx->C = C;
+    ctx->Q = Q;
+    hmac_stribog_hash_init(&ctx->H, C->hash_size);
+}
+
+void gost3410_verify_update(gost3410_verify_ctx_t *ctx, const unsigned char *data, size_t len) {
+    hmac_stribog_hash_update(&ctx->H, data, len);
+}
+
+int gost3410_verify_final(gost3410_verify_ctx_t *ctx, const mpz_t r, const mpz_t s) {
+    const gost_curve_t *C = ctx->C;
+    unsigned char h[OUTPUT_SIZE_512];
+    size_t hlen = gost3410_stream_digest(h, &ctx->H);
+
+    return gost3410_verify_hash(h, hlen, r, s, ctx->Q, C->q, NULL, NULL, NULL, &C->T, NULL, NULL, &C->Fq, NULL);
+}
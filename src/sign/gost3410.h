@@ -1,44 +1,272 @@
-#ifndef GOST3410_H
-#define GOST3410_H
-
-#include <stddef.h>
-#include <gmp.h>
-#include "../ec/ec_point.h"
-
-/*
- * Функция формирования цифровой подписи ГОСТ 34.10–2018.
- *
- * Параметры:
- *   r, s         – mpz_t для выходных значений подписи.
- *   message      – сообщение для подписи (массив байт) и его длина.
- *   d            – закрытый ключ (0 < d < q).
- *   q            – порядок подгруппы эллиптической кривой.
- *   p, a         – параметры кривой: модуль конечного поля и коэффициент a.
- *   P            – базовая точка кривой.
- */
-void gost3410_sign(mpz_t r, mpz_t s,
-                   const unsigned char *message, size_t message_len,
-                   const mpz_t d, const mpz_t q,
-                   const mpz_t p, const mpz_t a,
-                   const EC_Point *P);
-
-/*
- * Функция проверки цифровой подписи ГОСТ 34.10–2018.
- *
- * Параметры:
- *   message      – сообщение, которое подписывали.
- *   r, s         – компоненты подписи.
- *   Q            – публичный ключ (Q = d*P).
- *   q            – порядок подгруппы эллиптической кривой.
- *   p, a         – параметры кривой.
- *   P            – базовая точка кривой.
- *
- * Возвращает 1, если подпись корректна, 0 – иначе.
- */
-int gost3410_verify(const unsigned char *message, size_t message_len,
-                    const mpz_t r, const mpz_t s,
-                    const EC_Point *Q,
-                    const mpz_t q, const mpz_t p, const mpz_t a,
-                    const EC_Point *P);
-
-#endif // GOST3410_H
+#ifndef GOST3410_H
+#define GOST3410_H
+
+#include <stddef.h>
+#include <gmp.h>
+#include "../ec/ec_point.h"
+#include "../ec/ec_table.h"
+#include "gost_curve.h"
+#include "gost_presig.h"
+#include "gost_helper.h"
+#include "gost_workspace.h"
+#include "../hash/hmac_stribog.h"
+
+/* Начиная с этой длины сообщения gost3410_sign, gost3410_sign_table и
+   gost3410_sign_curve считают k*P во втором потоке одновременно с хэшем.
+   Для коротких сообщений выигрыш меньше цены создания потока. */
+#ifndef GOST3410_OVERLAP_MIN
+#define GOST3410_OVERLAP_MIN    (16 * 1024)
+#endif
+
+/*
+ * Функция формирования цифровой подписи ГОСТ 34.10–2018.
+ * Сообщение хэшируется 256-битным Стрибогом для кривых с q < 2^256
+ * и 512-битным для 512-битных кривых.
+ *
+ * Параметры:
+ *   r, s         – mpz_t для выходных значений подписи.
+ *   message      – сообщение для подписи (массив байт) и его длина.
+ *   d            – закрытый ключ (0 < d < q).
+ *   q            – порядок подгруппы эллиптической кривой.
+ *   p, a         – параметры кривой: модуль конечного поля и коэффициент a.
+ *   P            – базовая точка кривой.
+ */
+void gost3410_sign(mpz_t r, mpz_t s,
+                   const unsigned char *message, size_t message_len,
+                   const mpz_t d, const mpz_t q,
+                   const mpz_t p, const mpz_t a,
+                   const EC_Point *P);
+
+/*
+ * Функция проверки цифровой подписи ГОСТ 34.10–2018.
+ *
+ * Параметры:
+ *   message      – сообщение, которое подписывали.
+ *   r, s         – компоненты подписи.
+ *   Q            – публичный ключ (Q = d*P).
+ *   q            – порядок подгруппы эллиптической кривой.
+ *   p, a         – параметры кривой.
+ *   P            – базовая точка кривой.
+ *
+ * Возвращает 1, если подпись корректна, 0 – иначе.
+ */
+int gost3410_verify(const unsigned char *message, size_t message_len,
+                    const mpz_t r, const mpz_t s,
+                    const EC_Point *Q,
+                    const mpz_t q, const mpz_t p, const mpz_t a,
+                    const EC_Point *P);
+
+/*
+ * Формирование подписи с заранее построенной таблицей фиксированной базы T
+ * (см. ec_table_init): k*P вычисляется без удвоений. Параметры кривой и
+ * базовая точка берутся из таблицы.
+ */
+void gost3410_sign_table(mpz_t r, mpz_t s,
+                         const unsigned char *message, size_t message_len,
+                         const mpz_t d, const mpz_t q,
+                         const ec_table_t *T);
+
+/*
+ * Проверка подписи с таблицей фиксированной базы T; z1*P считается по таблице.
+ */
+int gost3410_verify_table(const unsigned char *message, size_t message_len,
+                          const mpz_t r, const mpz_t s,
+                          const EC_Point *Q, const mpz_t q,
+                          const ec_table_t *T);
+
+/*
+ * Формирование и проверка подписи на кривой из реестра (см. gost_curve_get)
+ * или на заранее построенном контексте: разбор параметров и построение
+ * таблиц при вызове не выполняются.
+ */
+void gost3410_sign_curve(mpz_t r, mpz_t s,
+                         const unsigned char *message, size_t message_len,
+                         const mpz_t d, const gost_curve_t *C);
+
+int gost3410_verify_curve(const unsigned char *message, size_t message_len,
+                          const mpz_t r, const mpz_t s,
+                          const EC_Point *Q, const gost_curve_t *C);
+
+/*
+ * Подпись и проверка на кривой C с рабочей областью W вызывающего потока
+ * (gost_workspace.h): при повторных вызовах память из кучи не выделяется,
+ * если r и s — инициализированные ранее и уже использованные (или созданные
+ * через mpz_init2 на FP_MAX_BITS) mpz_t, а Q — точка с координатами в
+ * диапазоне [0, p). Длинные сообщения подписываются без второго потока.
+ */
+void gost3410_sign_curve_ws(mpz_t r, mpz_t s,
+                            const unsigned char *message, size_t message_len,
+                            const mpz_t d, const gost_curve_t *C, gost_workspace_t *W);
+
+int gost3410_verify_curve_ws(const unsigned char *message, size_t message_len,
+                             const mpz_t r, const mpz_t s,
+                             const EC_Point *Q, const gost_curve_t *C, gost_workspace_t *W);
+
+/*
+ * Формирование подписи на кривой C с детерминированным одноразовым числом:
+ * k выводится из d и хэша сообщения по схеме RFC 6979 на HMAC-Стрибоге
+ * (gost_rfc6979.h) без обращений к генератору случайных чисел. Одно и то же
+ * сообщение с тем же ключом всегда даёт одну и ту же подпись; проверяется
+ * она обычным gost3410_verify_curve.
+ */
+void gost3410_sign_curve_det(mpz_t r, mpz_t s,
+                             const unsigned char *message, size_t message_len,
+                             const mpz_t d, const gost_curve_t *C);
+
+/*
+ * Формирование подписи ключом d с заранее посчитанной парой (k, r) из пула
+ * предподписей (gost_presig.h) на его кривой: при вызове остаются хэш и
+ * s = r*d + k*e mod q. Если пул пуст, подпись формируется обычным образом.
+ */
+void gost3410_sign_presig(mpz_t r, mpz_t s,
+                          const unsigned char *message, size_t message_len,
+                          const mpz_t d, gost_presig_t *pool);
+
+/*
+ * Подпись и проверка по готовому хэшу сообщения (например, посчитанному
+ * при потоковом чтении или на стороне клиента): сообщение повторно не
+ * хэшируется. digest — хэш в записи стандарта, как его выдаёт
+ * gost3410_hash (старший байт первым); его длина должна совпадать с
+ * размером хэша кривой: 32 байта (Стрибог-256) для q < 2^256, 64 байта
+ * (Стрибог-512) для 512-битных кривых. gost3410_hash записывает хэш
+ * сообщения в h (не меньше 64 байт) и возвращает его длину.
+ * gost3410_sign_digest возвращает 0, -1 при неверной длине хэша;
+ * gost3410_verify_digest — 1, если подпись верна, 0 иначе (в том числе
+ * при неверной длине хэша).
+ *
+ * Хэш в порядке строки байт RFC 7836 — результат hmac_stribog_hash_final,
+ * OpenSSL и других реализаций — записан в обратном порядке и без
+ * перестановки даёт неверную подпись; gost3410_digest_from_rfc переводит
+ * его в запись стандарта (h и digest могут совпадать). Для потока, который
+ * хэшируется здесь же, то же делает gost3410_stream_digest (см. ниже).
+ */
+size_t gost3410_hash(unsigned char *h, const unsigned char *message, size_t message_len,
+                     const gost_curve_t *C);
+
+void gost3410_digest_from_rfc(unsigned char *h, const unsigned char *digest, size_t len);
+
+int gost3410_sign_digest(mpz_t r, mpz_t s,
+                         const unsigned char *digest, size_t digest_len,
+                         const mpz_t d, const gost_curve_t *C);
+
+int gost3410_verify_digest(const unsigned char *digest, size_t digest_len,
+                           const mpz_t r, const mpz_t s,
+                           const EC_Point *Q, const gost_curve_t *C);
+
+/*
+ * Потоковые подпись и проверка: сообщение подаётся частями через update и
+ * целиком в памяти не хранится. Поток хэшируется как строка байт в порядке
+ * RFC 7836 (первый поданный байт обрабатывается первым, хэш читается как
+ * число от младшего байта), как у OpenSSL и других реализаций. Однопроходные
+ * gost3410_sign* принимают сообщение как число в записи стандарта и
+ * обрабатывают его с конца, поэтому подпись тех же байт в двух режимах
+ * различается: подписанное потоково проверяется потоково, и наоборот.
+ *
+ * Безопасность: потоковая подпись сообщения M верна для однопроходной
+ * проверки сообщения с обратным порядком байт, и наоборот (хэш один и тот
+ * же, различается только порядок чтения). Подпись, полученная в одном
+ * режиме, переносится в другой на другое сообщение. Один ключ не следует
+ * использовать с обоими режимами; если это нужно, режим должен входить
+ * в подписываемое сообщение.
+ *
+ * gost3410_sign_init запоминает копию ключа d; при первом update (или в
+ * final, если данных нет) выбирается случайное k и считается r = (k*P).x mod q,
+ * так что k*P выполняется, пока поток ещё читается, а final сводится к
+ * завершению хэша и s = r*d + k*e mod q. final записывает подпись в
+ * инициализированные r, s и стирает контекст; после final контекст
+ * используется только после нового init.
+ *
+ * gost3410_verify_init запоминает указатели на Q и C, они должны быть живы
+ * до final. gost3410_verify_final возвращает 1, если подпись верна, 0 иначе.
+ *
+ * Чтобы подписать или проверить поток через gost3410_sign_digest и
+ * gost3410_verify_digest (например, когда хэш считается в другом месте),
+ * поток хэшируется hmac_stribog_hash_init(&H, C->hash_size) и
+ * hmac_stribog_hash_update, а gost3410_stream_digest завершает хэш и
+ * записывает его в h (не меньше 64 байт) в записи стандарта, которую ждут
+ * эти функции; возвращает длину хэша, H после вызова стёрт. Подпись по такому
+ * хэшу совпадает по смыслу с потоковой: gost3410_sign_final и
+ * gost3410_verify_final её принимают.
+ */
+typedef struct {
+    const gost_curve_t *C;
+    hmac_stribog_hash_t H;
+    mpz_t d, k, r;
+    int ready;                      // k и r посчитаны
+} gost3410_sign_ctx_t;
+
+typedef struct {
+    const gost_curve_t *C;
+    const EC_Point *Q;
+    hmac_stribog_hash_t H;
+} gost3410_verify_ctx_t;
+
+void gost3410_sign_init(gost3410_sign_ctx_t *ctx, const mpz_t d, const gost_curve_t *C);
+void gost3410_sign_update(gost3410_sign_ctx_t *ctx, const unsigned char *data, size_t len);
+void gost3410_sign_final(gost3410_sign_ctx_t *ctx, mpz_t r, mpz_t s);
+
+void gost3410_verify_init(gost3410_verify_ctx_t *ctx, const EC_Point *Q, const gost_curve_t *C);
+void gost3410_verify_update(gost3410_verify_ctx_t *ctx, const unsigned char *data, size_t len);
+int gost3410_verify_final(gost3410_verify_ctx_t *ctx, const mpz_t r, const mpz_t s);
+
+size_t gost3410_stream_digest(unsigned char *h, hmac_stribog_hash_t *H);
+
+/*
+ * Генерация пары ключей на кривой C: закрытый ключ d равномерно из [1, q-1]
+ * берётся из генератора потока (gost_rand.h), открытый Q = d*P считается по
+ * таблице за постоянное время. Q должна быть инициализирована.
+ * Возвращает 0 при успехе, -1, если источник энтропии недоступен.
+ */
+int gost3410_keygen(mpz_t d, EC_Point *Q, const gost_curve_t *C);
+
+/*
+ * Пакетное формирование подписей n сообщений одним ключом d на кривой C.
+ * Точки k_i*P считаются по таблице фиксированной базы и переводятся в
+ * аффинные координаты одним обращением на часть пакета; хэширование и
+ * умножения распределяются по nthreads потокам (0 или 1 — в вызывающем).
+ * r[i], s[i] должны быть инициализированы. Возвращает 0 при успехе,
+ * -1 при нехватке памяти или недоступном источнике энтропии.
+ */
+int gost3410_sign_batch(mpz_t r[], mpz_t s[],
+                        const unsigned char *const messages[], const size_t message_lens[],
+                        size_t n, const mpz_t d, const gost_curve_t *C, int nthreads);
+
+/*
+ * Пакетная проверка n подписей (r[i], s[i]) сообщений messages[i] ключами Q[i]
+ * на кривой C. В valid[i] (если valid не NULL) записывается 1 или 0 для
+ * каждой подписи. Работа делится между nthreads потоками.
+ * Возвращает 1, если верны все подписи, 0 — если хотя бы одна неверна,
+ * -1 при нехватке памяти.
+ */
+int gost3410_verify_batch(int valid[],
+                          const unsigned char *const messages[], const size_t message_lens[],
+                          mpz_t r[], mpz_t s[], const EC_Point *const Q[],
+                          size_t n, const gost_curve_t *C, int nthreads);
+
+/*
+ * Проверка подписи ключом, для которого построена таблица TQ (ec_table_init
+ * или ec_table_file_find для ключа Q на кривой C): z2*Q тоже считается без удвоений.
+ */
+int gost3410_verify_curve_key(const unsigned char *message, size_t message_len,
+                              const mpz_t r, const mpz_t s,
+                              const ec_table_t *TQ, const gost_curve_t *C);
+
+/*
+ * Проверка с уменьшенной задержкой для интерактивных вызовов: z2*Q считает
+ * свободный помощник из H (gost_helper.h), z1*P по таблице — вызывающий
+ * поток, затем точки складываются. Если все помощники заняты, оба
+ * умножения выполняются в вызывающем потоке. Для пропускной способности
+ * выгоднее gost3410_verify_batch.
+ */
+int gost3410_verify_curve_split(const unsigned char *message, size_t message_len,
+                                const mpz_t r, const mpz_t s,
+                                const EC_Point *Q, const gost_curve_t *C,
+                                gost_helper_pool_t *H);
+
+/* То же с таблицей открытого ключа TQ: оба умножения без удвоений и примерно равны */
+int gost3410_verify_curve_key_split(const unsigned char *message, size_t message_len,
+                                    const mpz_t r, const mpz_t s,
+                                    const ec_table_t *TQ, const gost_curve_t *C,
+                                    gost_helper_pool_t *H);
+
+#endif // GOST3410_H
@@ -0,0 +1,111 @@
+#include "gost_curve.h"
+#include "../hash/hmac_stribog.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef GOST_BAKED_TABLES
+// Таблицы встроенных кривых, сгенерированные tools/gen_tables.c
+#include "gost_baked_tables.h"
+#endif
+
+static int gost_curve_setup(gost_curve_t *C, const ec_table_file_t *TF) {
+    size_t bits = mpz_sizeinbase(C->q, 2);
+
+    C->hash_size = bits > 256 ? HASH512 : HASH256;
+    if (fp_ctx_init(&C->Fq, C->q) != 0)
+        return -1;
+    C->Fq.ct = 1;           // d и k секретны
+#ifdef GOST_BAKED_TABLES
+    for (size_t i = 0; C->oid && i < sizeof(gost_baked_tables) / sizeof(gost_baked_tables[0]); i++) {
+        if (strcmp(gost_baked_tables[i].oid, C->oid) == 0 &&
+            ec_table_init_static(&C->T, &C->P, C->p, C->a, bits,
+                                 gost_baked_tables[i].pts, gost_baked_tables[i].count) == 0)
+            return 0;
+    }
+#endif
+    if (TF && ec_table_file_find(TF, &C->T, &C->P, C->p, C->a, bits) == 0)
+        return 0;
+    return ec_table_init(&C->T, &C->P, C->p, C->a, bits);
+}
+
+int gost_curve_init_params(gost_curve_t *C, const gost_paramset_t *ps) {
+    mpz_inits(C->p, C->a, C->b, C->q, NULL);
+    ec_point_init(&C->P);
+    C->name = ps->name;
+    C->oid = ps->oid;
+
+    mpz_set_str(C->p, ps->p, 16);
+    mpz_set_str(C->a, ps->a, 16);
+    mpz_set_str(C->b, ps->b, 16);
+    mpz_set_str(C->q, ps->q, 16);
+    mpz_set_str(C->P.x, ps->x, 16);
+    mpz_set_str(C->P.y, ps->y, 16);
+    C->P.infinity = 0;
+
+    if (gost_curve_setup(C, NULL) != 0) {
+        mpz_clears(C->p, C->a, C->b, C->q, NULL);
+        ec_point_clear(&C->P);
+        return -1;
+    }
+    return 0;
+}
+
+int gost_curve_init(gost_curve_t *C, const mpz_t p, const mpz_t a, const mpz_t b,
+                    const mpz_t q, const EC_Point *P) {
+    return gost_curve_init_file(C, p, a, b, q, P, NULL);
+}
+
+int gost_curve_init_file(gost_curve_t *C, const mpz_t p, const mpz_t a, const mpz_t b,
+                         const mpz_t q, const EC_Point *P, const ec_table_file_t *TF) {
+    mpz_init_set(C->p, p);
+    mpz_init_set(C->a, a);
+    mpz_init_set(C->b, b);
+    mpz_init_set(C->q, q);
+    ec_point_init(&C->P);
+    ec_point_copy(&C->P, P);
+    C->name = NULL;
+    C->oid = NULL;
+
+    if (gost_curve_setup(C, TF) != 0) {
+        mpz_clears(C->p, C->a, C->b, C->q, NULL);
+        ec_point_clear(&C->P);
+        return -1;
+    }
+    return 0;
+}
+
+void gost_curve_clear(gost_curve_t *C) {
+    ec_table_clear(&C->T);
+    ec_point_clear(&C->P);
+    mpz_clears(C->p, C->a, C->b, C->q, NULL);
+}
+
+/* Реестр: по одному контексту на каждый встроенный набор параметров */
+static pthread_mutex_t gost_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static gost_curve_t *gost_registry[64];
+
+const gost_curve_t *gost_curve_get(const char *name_or_oid) {
+    const gost_paramset_t *ps = gost_paramset_find(name_or_oid);
+    size_t idx;
+    gost_curve_t *C;
+
+    if (!ps)
+        return NULL;
+    idx = (size_t)(ps - gost_paramsets);
+    if (idx >= sizeof(gost_registry) / sizeof(gost_registry[0]))
+        return NULL;
+
+    pthread_mutex_lock(&gost_registry_lock);
+    C = gost_registry[idx];
+    if (!C) {
+        C = (gost_curve_t *)malloc(sizeof(gost_curve_t));
+        if (C && gost_curve_init_params(C, ps) != 0) {
+            free(C);
+            C = NULL;
+        }
+        gost_registry[idx] = C;
+    }
+    pthread_mutex_unlock(&gost_registry_lock);
+    return C;
+}
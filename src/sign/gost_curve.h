@@ -0,0 +1,47 @@
+#ifndef GOST_CURVE_H
+#define GOST_CURVE_H
+
+#include <stddef.h>
+#include <gmp.h>
+#include "../ec/ec_point.h"
+#include "../ec/ec_table.h"
+#include "../ec/ec_table_file.h"
+#include "gost_params.h"
+
+/* Контекст кривой ГОСТ 34.10–2018: разобранные константы, параметры редукции
+   поля (T.E) и порядка подгруппы (Fq), таблица фиксированной базы (T). Строится один раз, после
+   построения только читается, поэтому один экземпляр можно использовать
+   из нескольких потоков одновременно. */
+typedef struct {
+    const char *name;       // имя набора параметров (NULL для пользовательской кривой)
+    const char *oid;
+    mpz_t p, a, b, q;
+    EC_Point P;             // базовая точка
+    ec_table_t T;           // таблица для P и контекст арифметики кривой
+    fp_ctx_t Fq;            // арифметика скаляров по модулю q (режим ct)
+    int hash_size;          // HASH256 или HASH512 в зависимости от размера q
+} gost_curve_t;
+
+/* Построение контекста по стандартному набору параметров. Возвращает 0 при успехе. */
+int gost_curve_init_params(gost_curve_t *C, const gost_paramset_t *ps);
+
+/* Построение контекста для пользовательской кривой y^2 = x^3 + a*x + b (mod p)
+   с базовой точкой P порядка q. Возвращает 0 при успехе. */
+int gost_curve_init(gost_curve_t *C, const mpz_t p, const mpz_t a, const mpz_t b,
+                    const mpz_t q, const EC_Point *P);
+
+/* То же, но таблица базовой точки берётся из открытого файла предвычислений TF
+   (см. ec_table_file.h), если она там есть; иначе строится. Файл должен
+   оставаться открытым, пока используется контекст. */
+int gost_curve_init_file(gost_curve_t *C, const mpz_t p, const mpz_t a, const mpz_t b,
+                         const mpz_t q, const EC_Point *P, const ec_table_file_t *TF);
+
+/* Освобождение ресурсов контекста */
+void gost_curve_clear(gost_curve_t *C);
+
+/* Реестр встроенных кривых: контекст по имени или OID. Контекст строится
+   при первом обращении и далее переиспользуется всеми потоками процесса.
+   Возвращает NULL, если набор не найден. */
+const gost_curve_t *gost_curve_get(const char *name_or_oid);
+
+#endif // GOST_CURVE_H
@@ -0,0 +1,92 @@
+#include "gost_drbg.h"
+#include <string.h>
+
+/* HMAC_DRBG_Update: K = HMAC(K, V || 0x00 || data), V = HMAC(K, V) и, если
+   данные непусты, ещё раз с байтом 0x01. Данные передаются тремя частями
+   (энтропия, nonce, персонализация), чтобы не собирать их в один буфер. */
+static void gost_drbg_update(gost_drbg_t *D,
+                             const void *a, size_t a_len,
+                             const void *b, size_t b_len,
+                             const void *c, size_t c_len) {
+    unsigned char K[GOST_DRBG_OUTLEN];
+    hmac_stribog_ctx_t H;
+    int have_data = a_len + b_len + c_len > 0;
+
+    for (unsigned char sep = 0x00; sep <= 0x01; sep++) {
+        H = D->K;
+        hmac_stribog_update(&H, D->V, GOST_DRBG_OUTLEN);
+        hmac_stribog_update(&H, &sep, 1);
+        hmac_stribog_update(&H, (const u8 *)a, a_len);
+        hmac_stribog_update(&H, (const u8 *)b, b_len);
+        hmac_stribog_update(&H, (const u8 *)c, c_len);
+        hmac_stribog_final(&H, K);
+        hmac_stribog_init(&D->K, HASH512, K, GOST_DRBG_OUTLEN);
+
+        H = D->K;
+        hmac_stribog_update(&H, D->V, GOST_DRBG_OUTLEN);
+        hmac_stribog_final(&H, D->V);
+        if (!have_data)
+            break;
+    }
+    memset(K, 0, sizeof(K));
+}
+
+int gost_drbg_instantiate(gost_drbg_t *D,
+                          const void *entropy, size_t entropy_len,
+                          const void *nonce, size_t nonce_len,
+                          const void *pers, size_t pers_len) {
+    unsigned char K[GOST_DRBG_OUTLEN] = {0};
+
+    if (entropy_len < GOST_DRBG_ENTROPY_MIN)
+        return -1;
+    hmac_stribog_init(&D->K, HASH512, K, GOST_DRBG_OUTLEN);
+    memset(D->V, 0x01, GOST_DRBG_OUTLEN);
+    gost_drbg_update(D, entropy, entropy_len, nonce, nonce ? nonce_len : 0,
+                     pers, pers ? pers_len : 0);
+    D->reseed_counter = 1;
+    D->reseed_interval = GOST_DRBG_RESEED_INTERVAL;
+    return 0;
+}
+
+int gost_drbg_reseed(gost_drbg_t *D, const void *entropy, size_t entropy_len,
+                     const void *add, size_t add_len) {
+    if (entropy_len < GOST_DRBG_ENTROPY_MIN)
+        return -1;
+    gost_drbg_update(D, entropy, entropy_len, add, add ? add_len : 0, NULL, 0);
+    D->reseed_counter = 1;
+    return 0;
+}
+
+int gost_drbg_generate(gost_drbg_t *D, void *out, size_t len,
+                       const void *add, size_t add_len) {
+    unsigned char *p = (unsigned char *)out;
+    hmac_stribog_ctx_t H;
+
+    if (len > GOST_DRBG_MAX_REQUEST)
+        return -1;
+    if (D->reseed_counter > D->reseed_interval)
+        return GOST_DRBG_NEED_RESEED;
+    if (!add)
+        add_len = 0;
+    if (add_len > 0)
+        gost_drbg_update(D, add, add_len, NULL, 0, NULL, 0);
+
+    // V = HMAC(K, V) на каждый блок; состояние после ключа копируется, а не пересчитывается
+    while (len > 0) {
+        size_t n = len < GOST_DRBG_OUTLEN ? len : GOST_DRBG_OUTLEN;
+        H = D->K;
+        hmac_stribog_update(&H, D->V, GOST_DRBG_OUTLEN);
+        hmac_stribog_final(&H, D->V);
+        memcpy(p, D->V, n);
+        p += n;
+        len -= n;
+    }
+
+    gost_drbg_update(D, add, add_len, NULL, 0, NULL, 0);
+    D->reseed_counter++;
+    return 0;
+}
+
+void gost_drbg_clear(gost_drbg_t *D) {
+    memset(D, 0, sizeof(*D));
+}
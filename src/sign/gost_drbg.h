@@ -0,0 +1,50 @@
+#ifndef GOST_DRBG_H
+#define GOST_DRBG_H
+
+#include <stddef.h>
+#include "../hash/hmac_stribog.h"
+
+/* Детерминированный генератор HMAC_DRBG (NIST SP 800-90A, разд. 10.1.2) на
+   HMAC-Стрибог-512: состояние — ключ K (хранится как состояние HMAC после
+   ключа, чтобы не пересчитывать K ^ ipad и K ^ opad на каждом блоке) и V по
+   64 байта. Уровень стойкости 256 бит: энтропия при создании и пересеве не
+   короче GOST_DRBG_ENTROPY_MIN байт. Без пересева генератор выдаёт не больше
+   reseed_interval запросов, каждый до GOST_DRBG_MAX_REQUEST байт; обновление
+   K и V после каждого запроса не даёт восстановить прошлый выход. */
+#define GOST_DRBG_OUTLEN            64
+#define GOST_DRBG_ENTROPY_MIN       32
+#define GOST_DRBG_MAX_REQUEST       (1UL << 16)   // 2^19 бит
+#define GOST_DRBG_RESEED_INTERVAL   (1UL << 24)
+
+/* Код gost_drbg_generate: исчерпан интервал, нужен gost_drbg_reseed */
+#define GOST_DRBG_NEED_RESEED       1
+
+typedef struct {
+    hmac_stribog_ctx_t K;
+    unsigned char V[GOST_DRBG_OUTLEN];
+    unsigned long reseed_counter;
+    unsigned long reseed_interval;      // GOST_DRBG_RESEED_INTERVAL, можно уменьшить
+} gost_drbg_t;
+
+/* Создание по энтропии, nonce и строке персонализации (nonce и pers могут
+   быть NULL). Возвращает 0, -1 при энтропии короче GOST_DRBG_ENTROPY_MIN. */
+int gost_drbg_instantiate(gost_drbg_t *D,
+                          const void *entropy, size_t entropy_len,
+                          const void *nonce, size_t nonce_len,
+                          const void *pers, size_t pers_len);
+
+/* Пересев свежей энтропией и необязательными дополнительными данными.
+   Возвращает 0, -1 при энтропии короче GOST_DRBG_ENTROPY_MIN. */
+int gost_drbg_reseed(gost_drbg_t *D, const void *entropy, size_t entropy_len,
+                     const void *add, size_t add_len);
+
+/* len байт выхода за один запрос (K и V обновляются один раз на запрос,
+   поэтому большие запросы дешевле на байт). Возвращает 0,
+   GOST_DRBG_NEED_RESEED, если интервал исчерпан, -1 при len > GOST_DRBG_MAX_REQUEST. */
+int gost_drbg_generate(gost_drbg_t *D, void *out, size_t len,
+                       const void *add, size_t add_len);
+
+/* Стирание состояния */
+void gost_drbg_clear(gost_drbg_t *D);
+
+#endif // GOST_DRBG_H
@@ -0,0 +1,117 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+#include "gost_helper.h"
+#include <stdlib.h>
+#include <sched.h>
+
+/* Состояния помощника */
+enum { GOST_HELPER_IDLE, GOST_HELPER_CLAIMED, GOST_HELPER_RUN, GOST_HELPER_DONE };
+
+/* Ожидание в цикле опроса; время от времени процессор уступается, чтобы
+   на машине с одним ядром опрашивающий поток не мешал тому, кого ждёт */
+static void gost_helper_relax(unsigned i) {
+    if (i % 64 == 63)
+        sched_yield();
+}
+
+static void *gost_helper_thread(void *arg) {
+    gost_helper_t *W = (gost_helper_t *)arg;
+
+#ifdef __linux__
+    if (W->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(W->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    for (;;) {
+        unsigned i;
+        for (i = 0; i < GOST_HELPER_SPIN; i++) {
+            if (atomic_load(&W->state) == GOST_HELPER_RUN || atomic_load(&W->stop))
+                break;
+            gost_helper_relax(i);
+        }
+        if (i == GOST_HELPER_SPIN) {
+            pthread_mutex_lock(&W->lock);
+            atomic_store(&W->sleeping, 1);
+            while (atomic_load(&W->state) != GOST_HELPER_RUN && !atomic_load(&W->stop))
+                pthread_cond_wait(&W->wake, &W->lock);
+            atomic_store(&W->sleeping, 0);
+            pthread_mutex_unlock(&W->lock);
+        }
+        if (atomic_load(&W->stop))
+            break;
+        W->fn(W->arg);
+        atomic_store(&W->state, GOST_HELPER_DONE);
+    }
+    return NULL;
+}
+
+gost_helper_t *gost_helper_submit(gost_helper_pool_t *H, gost_helper_fn fn, void *arg) {
+    for (size_t i = 0; i < H->n; i++) {
+        gost_helper_t *W = &H->helpers[i];
+        int idle = GOST_HELPER_IDLE;
+        if (!atomic_compare_exchange_strong(&W->state, &idle, GOST_HELPER_CLAIMED))
+            continue;
+        W->fn = fn;
+        W->arg = arg;
+        atomic_store(&W->state, GOST_HELPER_RUN);
+        if (atomic_load(&W->sleeping)) {
+            pthread_mutex_lock(&W->lock);
+            pthread_cond_signal(&W->wake);
+            pthread_mutex_unlock(&W->lock);
+        }
+        return W;
+    }
+    return NULL;
+}
+
+void gost_helper_wait(gost_helper_t *W) {
+    for (unsigned i = 0; atomic_load(&W->state) != GOST_HELPER_DONE; i++)
+        gost_helper_relax(i);
+    atomic_store(&W->state, GOST_HELPER_IDLE);
+}
+
+int gost_helper_pool_init(gost_helper_pool_t *H, size_t n, const int *cpus) {
+    H->n = 0;
+    H->helpers = (gost_helper_t *)calloc(n ? n : 1, sizeof(gost_helper_t));
+    if (!H->helpers)
+        return -1;
+
+    for (size_t i = 0; i < n; i++) {
+        gost_helper_t *W = &H->helpers[i];
+        atomic_init(&W->state, GOST_HELPER_IDLE);
+        atomic_init(&W->sleeping, 0);
+        atomic_init(&W->stop, 0);
+        W->cpu = cpus ? cpus[i] : -1;
+        pthread_mutex_init(&W->lock, NULL);
+        pthread_cond_init(&W->wake, NULL);
+        if (pthread_create(&W->thread, NULL, gost_helper_thread, W) != 0) {
+            pthread_mutex_destroy(&W->lock);
+            pthread_cond_destroy(&W->wake);
+            gost_helper_pool_clear(H);
+            return -1;
+        }
+        H->n++;
+    }
+    return 0;
+}
+
+void gost_helper_pool_clear(gost_helper_pool_t *H) {
+    for (size_t i = 0; i < H->n; i++) {
+        gost_helper_t *W = &H->helpers[i];
+        pthread_mutex_lock(&W->lock);
+        atomic_store(&W->stop, 1);
+        pthread_cond_signal(&W->wake);
+        pthread_mutex_unlock(&W->lock);
+        pthread_join(W->thread, NULL);
+        pthread_mutex_destroy(&W->lock);
+        pthread_cond_destroy(&W->wake);
+    }
+    free(H->helpers);
+    H->helpers = NULL;
+    H->n = 0;
+}
@@ -0,0 +1,51 @@
+#ifndef GOST_HELPER_H
+#define GOST_HELPER_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/* Постоянные потоки-помощники для разделения одной операции между вызывающим
+   потоком и помощником (например, z1*P и z2*Q при проверке подписи). Каждый
+   помощник выполняет одну задачу за раз; свободный выбирается атомарной
+   сменой состояния, а если заняты все, вызывающий выполняет задачу сам.
+   После задачи помощник GOST_HELPER_SPIN итераций опрашивает состояние и
+   только потом засыпает на условной переменной, так что запросы, идущие
+   подряд, не платят за пробуждение потока. Помощников можно закрепить за
+   отдельными ядрами (на Linux). */
+#define GOST_HELPER_SPIN    20000
+
+typedef void (*gost_helper_fn)(void *arg);
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_int state;               // свободен, занят, задача передана, выполнена
+    atomic_int sleeping;
+    atomic_int stop;
+    gost_helper_fn fn;
+    void *arg;
+    int cpu;                        // ядро для закрепления или -1
+} gost_helper_t;
+
+typedef struct {
+    gost_helper_t *helpers;
+    size_t n;
+} gost_helper_pool_t;
+
+/* n помощников; cpus (может быть NULL) — номера ядер, за которыми они
+   закрепляются. Возвращает 0, -1 при нехватке памяти или ошибке создания потока. */
+int gost_helper_pool_init(gost_helper_pool_t *H, size_t n, const int *cpus);
+
+/* Запуск fn(arg) на свободном помощнике. Возвращает помощника, завершения
+   которого нужно дождаться gost_helper_wait, или NULL, если свободных нет. */
+gost_helper_t *gost_helper_submit(gost_helper_pool_t *H, gost_helper_fn fn, void *arg);
+
+/* Ожидание завершения задачи; после возврата помощник снова свободен */
+void gost_helper_wait(gost_helper_t *W);
+
+/* Остановка и освобождение помощников */
+void gost_helper_pool_clear(gost_helper_pool_t *H);
+
+#endif // GOST_HELPER_H
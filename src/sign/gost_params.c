@@ -0,0 +1,129 @@
+#include "gost_params.h"
+#include <string.h>
+
+const gost_paramset_t gost_paramsets[] = {
+    {
+        "id-GostR3410-2001-TestParamSet", "1.2.643.2.2.35.0",
+        "8000000000000000000000000000000000000000000000000000000000000431",
+        "7",
+        "5FBFF498AA938CE739B8E022FBAFEF40563F6E6A3472FC2A514C0CE9DAE23B7E",
+        "8000000000000000000000000000000150FE8A1892976154C59CFC193ACCF5B3",
+        "2",
+        "8E2A8A0E65147D4BD6316030E16D19C85C97F0A9CA267122B96ABBCEA7E8FC8"
+    },
+    {
+        "id-GostR3410-2001-CryptoPro-A-ParamSet", "1.2.643.2.2.35.1",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD94",
+        "A6",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF6C611070995AD10045841B09B761B893",
+        "1",
+        "8D91E471E0989CDA27DF505A453F2B7635294F2DDF23E3B122ACC99C9E9F1E14"
+    },
+    {
+        "id-GostR3410-2001-CryptoPro-B-ParamSet", "1.2.643.2.2.35.2",
+        "8000000000000000000000000000000000000000000000000000000000000C99",
+        "8000000000000000000000000000000000000000000000000000000000000C96",
+        "3E1AF419A269A5F866A7D3C25C3DF80AE979259373FF2B182F49D4CE7E1BBC8B",
+        "800000000000000000000000000000015F700CFFF1A624E5E497161BCC8A198F",
+        "1",
+        "3FA8124359F96680B83D1C3EB2C070E5C545C9858D03ECFB744BF8D717717EFC"
+    },
+    {
+        "id-GostR3410-2001-CryptoPro-C-ParamSet", "1.2.643.2.2.35.3",
+        "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D759B",
+        "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D7598",
+        "805A",
+        "9B9F605F5A858107AB1EC85E6B41C8AA582CA3511EDDFB74F02F3A6598980BB9",
+        "0",
+        "41ECE55743711A8C3CBF3783CD08C0EE4D4DC440D4641A8F366E550DFDB3BB67"
+    },
+    {
+        "id-tc26-gost-3410-2012-256-paramSetA", "1.2.643.7.1.2.1.1.1",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+        "C2173F1513981673AF4892C23035A27CE25E2013BF95AA33B22C656F277E7335",
+        "295F9BAE7428ED9CCC20E7C359A9D41A22FCCD9108E17BF7BA9337A6F8AE9513",
+        "400000000000000000000000000000000FD8CDDFC87B6635C115AF556C360C67",
+        "91E38443A5E82C0D880923425712B2BB658B9196932E02C78B2582FE742DAA28",
+        "32879423AB1A0375895786C4BB46E9565FDE0B5344766740AF268ADB32322E5C"
+    },
+    {
+        "id-tc26-gost-3410-12-512-paramSetA", "1.2.643.7.1.2.1.2.1",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC4",
+        "E8C2505DEDFC86DDC1BD0B2B6667F1DA34B82574761CB0E879BD081CFD0B6265"
+        "EE3CB090F30D27614CB4574010DA90DD862EF9D4EBEE4761503190785A71C760",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "27E69532F48D89116FF22B8D4E0560609B4B38ABFAD2B85DCACDB1411F10B275",
+        "3",
+        "7503CFE87A836AE3A61B8816E25450E6CE5E1C93ACF1ABC1778064FDCBEFA921"
+        "DF1626BE4FD036E93D75E6A50E3A41E98028FE5FC235F5B889A589CB5215F2A4"
+    },
+    {
+        "id-tc26-gost-3410-12-512-paramSetB", "1.2.643.7.1.2.1.2.2",
+        "8000000000000000000000000000000000000000000000000000000000000000"
+        "000000000000000000000000000000000000000000000000000000000000006F",
+        "8000000000000000000000000000000000000000000000000000000000000000"
+        "000000000000000000000000000000000000000000000000000000000000006C",
+        "687D1B459DC841457E3E06CF6F5E2517B97C7D614AF138BCBF85DC806C4B289F"
+        "3E965D2DB1416D217F8B276FAD1AB69C50F78BEE1FA3106EFB8CCBC7C5140116",
+        "8000000000000000000000000000000000000000000000000000000000000001"
+        "49A1EC142565A545ACFDB77BD9D40CFA8B996712101BEA0EC6346C54374F25BD",
+        "2",
+        "1A8F7EDA389B094C2C071E3647A8940F3C123B697578C213BE6DD9E6C8EC7335"
+        "DCB228FD1EDF4A39152CBCAAF8C0398828041055F94CEEEC7E21340780FE41BD"
+    },
+    {
+        "id-tc26-gost-3410-2012-512-paramSetC", "1.2.643.7.1.2.1.2.3",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+        "DC9203E514A721875485A529D2C722FB187BC8980EB866644DE41C68E1430645"
+        "46E861C0E2C9EDD92ADE71F46FCF50FF2AD97F951FDA9F2A2EB6546F39689BD3",
+        "B4C4EE28CEBC6C2C8AC12952CF37F16AC7EFB6A9F69F4B57FFDA2E4F0DE5ADE0"
+        "38CBC2FFF719D2C18DE0284B8BFEF3B52B8CC7A5F5BF0A3C8D2319A5312557E1",
+        "3FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+        "C98CDBA46506AB004C33A9FF5147502CC8EDA9E7A769A12694623CEF47F023ED",
+        "E2E31EDFC23DE7BDEBE241CE593EF5DE2295B7A9CBAEF021D385F7074CEA043A"
+        "A27272A7AE602BF2A7B9033DB9ED3610C6FB85487EAE97AAC5BC7928C1950148",
+        "F5CE40D95B5EB899ABBCCFF5911CB8577939804D6527378B8C108C3D2090FF9B"
+        "E18E2D33E3021ED2EF32D85822423B6304F726AA854BAE07D0396E9A9ADDC40F"
+    },
+};
+
+const size_t gost_paramsets_count = sizeof(gost_paramsets) / sizeof(gost_paramsets[0]);
+
+/* Синонимы: те же кривые под другими именами (наборы обмена ключами CryptoPro
+   и 256-битные наборы ТК 26, совпадающие с наборами CryptoPro) */
+static const struct {
+    const char *name, *oid, *target;
+} gost_paramset_aliases[] = {
+    { "id-GostR3410-2001-CryptoPro-XchA-ParamSet", "1.2.643.2.2.36.0", "1.2.643.2.2.35.1" },
+    { "id-GostR3410-2001-CryptoPro-XchB-ParamSet", "1.2.643.2.2.36.1", "1.2.643.2.2.35.3" },
+    { "id-tc26-gost-3410-2012-256-paramSetB", "1.2.643.7.1.2.1.1.2", "1.2.643.2.2.35.1" },
+    { "id-tc26-gost-3410-2012-256-paramSetC", "1.2.643.7.1.2.1.1.3", "1.2.643.2.2.35.2" },
+    { "id-tc26-gost-3410-2012-256-paramSetD", "1.2.643.7.1.2.1.1.4", "1.2.643.2.2.35.3" },
+};
+
+static const gost_paramset_t *gost_paramset_find_direct(const char *name_or_oid) {
+    for (size_t i = 0; i < gost_paramsets_count; i++) {
+        if (strcmp(gost_paramsets[i].name, name_or_oid) == 0 ||
+            strcmp(gost_paramsets[i].oid, name_or_oid) == 0)
+            return &gost_paramsets[i];
+    }
+    return NULL;
+}
+
+const gost_paramset_t *gost_paramset_find(const char *name_or_oid) {
+    const gost_paramset_t *ps = gost_paramset_find_direct(name_or_oid);
+    if (ps)
+        return ps;
+
+    for (size_t i = 0; i < sizeof(gost_paramset_aliases) / sizeof(gost_paramset_aliases[0]); i++) {
+        if (strcmp(gost_paramset_aliases[i].name, name_or_oid) == 0 ||
+            strcmp(gost_paramset_aliases[i].oid, name_or_oid) == 0)
+            return gost_paramset_find_direct(gost_paramset_aliases[i].target);
+    }
+    return NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef GOST_PARAMS_H
+#define GOST_PARAMS_H
+
+#include <stddef.h>
+
+/* Стандартный набор параметров эллиптической кривой ГОСТ 34.10–2018
+   (шестнадцатеричная запись, как в рекомендациях ТК 26). Кривая задана
+   в форме y^2 = x^3 + a*x + b (mod p), q — порядок базовой точки (x, y). */
+typedef struct {
+    const char *name;   // имя набора, например "id-tc26-gost-3410-12-512-paramSetA"
+    const char *oid;    // OID в точечной записи
+    const char *p;
+    const char *a;
+    const char *b;
+    const char *q;
+    const char *x;
+    const char *y;
+} gost_paramset_t;
+
+/* Таблица встроенных наборов параметров */
+extern const gost_paramset_t gost_paramsets[];
+extern const size_t gost_paramsets_count;
+
+/* Поиск набора по имени или OID (в том числе по синонимам: CryptoPro-XchA/XchB,
+   tc26 256-paramSetB/C/D). Возвращает NULL, если набор не найден. */
+const gost_paramset_t *gost_paramset_find(const char *name_or_oid);
+
+#endif // GOST_PARAMS_H
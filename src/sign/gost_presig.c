@@ -0,0 +1,223 @@
+#include "gost_presig.h"
+#include "gost_rand.h"
+#include "../ec/ec_point.h"
+#include "../ec/ec_table.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Запись пары в очередь; 0, если очередь полна */
+static int gost_presig_push(gost_presig_t *P, const mpz_t k, const mpz_t r, unsigned gen) {
+    size_t pos = atomic_load_explicit(&P->tail, memory_order_relaxed);
+    gost_presig_slot_t *slot;
+
+    for (;;) {
+        slot = &P->slots[pos & P->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak(&P->tail, &pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&P->tail, memory_order_relaxed);
+        }
+    }
+
+    mpn_zero(slot->k, P->n);
+    mpn_zero(slot->r, P->n);
+    mpn_copyi(slot->k, mpz_limbs_read(k), (mp_size_t)mpz_size(k));
+    mpn_copyi(slot->r, mpz_limbs_read(r), (mp_size_t)mpz_size(r));
+    slot->fork_gen = gen;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return 1;
+}
+
+/* Пробуждение потока пополнения, если он спит, а пул опустел до четверти.
+   В дочернем процессе потока нет, а мьютекс и условная переменная — копии
+   родительских, поэтому там они не трогаются. */
+static void gost_presig_wake(gost_presig_t *P, unsigned gen) {
+    if (!atomic_load(&P->sleeping) || P->fork_gen != gen ||
+        gost_presig_available(P) > (P->mask + 1) / 4)
+        return;
+    pthread_mutex_lock(&P->lock);
+    pthread_cond_signal(&P->wake);
+    pthread_mutex_unlock(&P->lock);
+}
+
+size_t gost_presig_available(gost_presig_t *P) {
+    size_t head = atomic_load(&P->head), tail = atomic_load(&P->tail);
+    return tail > head ? tail - head : 0;
+}
+
+int gost_presig_take(gost_presig_t *P, mpz_t k, mpz_t r) {
+    unsigned gen = gost_rand_fork_generation();
+    gost_presig_slot_t *slot;
+    size_t pos;
+    int own;
+
+    do {
+        pos = atomic_load_explicit(&P->head, memory_order_relaxed);
+        for (;;) {
+            slot = &P->slots[pos & P->mask];
+            size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (atomic_compare_exchange_weak(&P->head, &pos, pos + 1))
+                    break;
+            } else if (diff < 0) {
+                gost_presig_wake(P, gen);
+                return 0;
+            } else {
+                pos = atomic_load_explicit(&P->head, memory_order_relaxed);
+            }
+        }
+
+        // Пара из родительского процесса не выдаётся: тот же k мог уйти в его подпись
+        own = slot->fork_gen == gen;
+        if (own) {
+            mpn_copyi(mpz_limbs_write(k, P->n), slot->k, P->n);
+            mpz_limbs_finish(k, P->n);
+            mpn_copyi(mpz_limbs_write(r, P->n), slot->r, P->n);
+            mpz_limbs_finish(r, P->n);
+        }
+        mpn_zero(slot->k, P->n);
+        mpn_zero(slot->r, P->n);
+        atomic_store_explicit(&slot->seq, pos + P->mask + 1, memory_order_release);
+    } while (!own);
+
+    gost_presig_wake(P, gen);
+    return 1;
+}
+
+size_t gost_presig_fill(gost_presig_t *P, size_t want) {
+    const gost_curve_t *C = P->C;
+    ec_jpoint_t J[GOST_PRESIG_BATCH];
+    ec_apoint_t A[GOST_PRESIG_BATCH];
+    mpz_t k[GOST_PRESIG_BATCH], r;
+    size_t added = 0, cap = P->mask + 1;
+    unsigned gen = gost_rand_fork_generation();
+    int full = 0, starved = 0;
+
+    for (size_t i = 0; i < GOST_PRESIG_BATCH; i++)
+        mpz_init(k[i]);
+    mpz_init(r);
+
+    while (added < want && !full && !starved) {
+        size_t used = gost_presig_available(P), m = want - added;
+        if (used >= cap)
+            break;
+        if (m > cap - used)
+            m = cap - used;
+        if (m > GOST_PRESIG_BATCH)
+            m = GOST_PRESIG_BATCH;
+
+        for (size_t i = 0; i < m; i++) {
+            if (gost_rand_scalar(k[i], C->q) != 0) {
+                starved = 1;        // нет энтропии: пополнять нечем
+                m = i;
+                break;
+            }
+            ec_jpoint_mul_table_ct(&C->T, &J[i], k[i]);
+        }
+        ec_points_normalize_batch(&C->T.E, A, J, m);
+
+        for (size_t i = 0; i < m; i++) {
+            if (A[i].infinity)
+                continue;
+            fp_to_mpz(&C->T.E.F, r, &A[i].x);
+            mpz_mod(r, r, C->q);
+            if (mpz_sgn(r) == 0)
+                continue;
+            if (full || !gost_presig_push(P, k[i], r, gen)) {
+                full = 1;
+                continue;
+            }
+            added++;
+        }
+    }
+
+    for (size_t i = 0; i < GOST_PRESIG_BATCH; i++) {
+        mpz_set_ui(k[i], 0);
+        mpz_clear(k[i]);
+    }
+    mpz_clear(r);
+    return added;
+}
+
+/* Поток пополнения: досчитывает пул до полного и спит, пока в нём больше
+   четверти ёмкости */
+static void *gost_presig_thread(void *arg) {
+    gost_presig_t *P = (gost_presig_t *)arg;
+    size_t cap = P->mask + 1;
+
+    while (!atomic_load(&P->stop)) {
+        if (gost_presig_fill(P, cap) > 0)
+            continue;
+        if (gost_presig_available(P) <= cap / 4)
+            break;                  // не удалось посчитать ни одной пары: нет энтропии
+        pthread_mutex_lock(&P->lock);
+        atomic_store(&P->sleeping, 1);
+        while (!atomic_load(&P->stop) && gost_presig_available(P) > cap / 4)
+            pthread_cond_wait(&P->wake, &P->lock);
+        atomic_store(&P->sleeping, 0);
+        pthread_mutex_unlock(&P->lock);
+    }
+    return NULL;
+}
+
+int gost_presig_init(gost_presig_t *P, const gost_curve_t *C, size_t capacity, int background) {
+    size_t cap = 1;
+
+    while (cap < capacity)
+        cap <<= 1;
+    memset(P, 0, sizeof(*P));
+    P->C = C;
+    P->mask = cap - 1;
+    P->n = (mp_size_t)mpz_size(C->q);
+    P->slots = (gost_presig_slot_t *)calloc(cap, sizeof(gost_presig_slot_t));
+    if (!P->slots)
+        return -1;
+    for (size_t i = 0; i < cap; i++)
+        atomic_init(&P->slots[i].seq, i);
+    atomic_init(&P->head, 0);
+    atomic_init(&P->tail, 0);
+    atomic_init(&P->sleeping, 0);
+    atomic_init(&P->stop, 0);
+    pthread_mutex_init(&P->lock, NULL);
+    pthread_cond_init(&P->wake, NULL);
+    P->fork_gen = gost_rand_fork_generation();
+
+    if (background) {
+        if (pthread_create(&P->thread, NULL, gost_presig_thread, P) != 0) {
+            gost_presig_clear(P);
+            return -1;
+        }
+        P->background = 1;
+    }
+    return 0;
+}
+
+void gost_presig_clear(gost_presig_t *P) {
+    int owner = P->fork_gen == gost_rand_fork_generation();
+
+    // Поток пополнения есть только в процессе, создавшем пул
+    if (P->background && owner) {
+        pthread_mutex_lock(&P->lock);
+        atomic_store(&P->stop, 1);
+        pthread_cond_signal(&P->wake);
+        pthread_mutex_unlock(&P->lock);
+        pthread_join(P->thread, NULL);
+    }
+    P->background = 0;
+    if (P->slots) {
+        memset(P->slots, 0, (P->mask + 1) * sizeof(gost_presig_slot_t));
+        free(P->slots);
+        P->slots = NULL;
+    }
+    if (owner) {
+        pthread_mutex_destroy(&P->lock);
+        pthread_cond_destroy(&P->wake);
+    }
+}
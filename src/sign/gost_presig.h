@@ -0,0 +1,68 @@
+#ifndef GOST_PRESIG_H
+#define GOST_PRESIG_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <gmp.h>
+#include "../ec/fp.h"
+#include "gost_curve.h"
+
+/* Пул предподписей: пары (k, r = (k*P).x mod q) не зависят ни от сообщения,
+   ни от ключа, поэтому считаются заранее, а подпись (gost3410_sign_presig)
+   сводится к хэшу и s = r*d + k*e mod q. Пул — ограниченная очередь
+   без блокировок (кольцо Вьюкова с номером последовательности в каждой
+   ячейке): любое число потоков забирает пары, каждая выдаётся ровно один раз
+   и стирается из ячейки. Пополняет пул фоновый поток (background != 0) или
+   вызывающий через gost_presig_fill. Фоновый поток засыпает на условной
+   переменной, когда пул полон, и будится, когда в нём остаётся меньше
+   четверти ёмкости; забирающие потоки берут мьютекс только для этого
+   сигнала. Пары, посчитанные до fork, в дочернем процессе не выдаются. */
+
+/* Пары считаются порциями: k_i*P переводятся в аффинные одним обращением */
+#define GOST_PRESIG_BATCH   16
+
+typedef struct {
+    atomic_size_t seq;
+    unsigned fork_gen;              // поколение процесса при вычислении
+    mp_limb_t k[FP_MAX_LIMBS];
+    mp_limb_t r[FP_MAX_LIMBS];
+} gost_presig_slot_t;
+
+typedef struct {
+    const gost_curve_t *C;
+    gost_presig_slot_t *slots;
+    size_t mask;                    // ёмкость - 1 (ёмкость — степень двойки)
+    mp_size_t n;                    // лимбов в q
+    atomic_size_t head;             // позиция следующей выдачи
+    atomic_size_t tail;             // позиция следующей записи
+    // Фоновое пополнение
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_int sleeping;
+    atomic_int stop;
+    int background;
+    unsigned fork_gen;              // поколение процесса, создавшего пул
+} gost_presig_t;
+
+/* Пул не меньше чем на capacity пар для кривой C (ёмкость округляется вверх
+   до степени двойки). При background != 0 запускается поток пополнения.
+   Пул сразу не заполняется. Возвращает 0, -1 при нехватке памяти или
+   ошибке создания потока. */
+int gost_presig_init(gost_presig_t *P, const gost_curve_t *C, size_t capacity, int background);
+
+/* Досчитывает до want пар (не больше свободного места) в вызывающем потоке.
+   Возвращает число добавленных пар. */
+size_t gost_presig_fill(gost_presig_t *P, size_t want);
+
+/* Число готовых пар (приблизительно при одновременной работе потоков) */
+size_t gost_presig_available(gost_presig_t *P);
+
+/* Следующая пара в k, r. Возвращает 1, 0 если пул пуст. */
+int gost_presig_take(gost_presig_t *P, mpz_t k, mpz_t r);
+
+/* Остановка потока пополнения, стирание и освобождение пула */
+void gost_presig_clear(gost_presig_t *P);
+
+#endif // GOST_PRESIG_H
@@ -0,0 +1,289 @@
+#ifdef _WIN32
+#define _CRT_RAND_S
+#endif
+#include "gost_rand.h"
+#include "gost_drbg.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <errno.h>
+#include <sys/random.h>
+#elif !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define GOST_RAND_KEY_SIZE  32
+#define GOST_RAND_BUF_SIZE  (GOST_RAND_BLOCKS * 64)
+// Наибольшая порция, которую запрос на много байт получает мимо буфера
+#define GOST_RAND_BULK      GOST_DRBG_MAX_REQUEST
+
+/* Состояние генератора одного потока */
+typedef struct {
+#ifdef GOST_RAND_CHACHA20
+    uint32_t key[8];                        // ключ ChaCha20
+#else
+    gost_drbg_t drbg;                       // HMAC_DRBG на Стрибоге-512
+#endif
+    unsigned char buf[GOST_RAND_BUF_SIZE];  // выход последнего пополнения
+    size_t pos;                             // выданная часть буфера (уже стёрта)
+    unsigned long since_seed;               // байт выдано с последнего засева
+    unsigned fork_gen;                      // поколение процесса при засеве
+    int seeded;
+} gost_rand_state_t;
+
+static _Thread_local gost_rand_state_t gost_rand_tls;
+
+/* Поколение процесса: увеличивается в дочернем процессе после fork, и потоки
+   замечают это сравнением с сохранённым значением без системного вызова */
+static volatile unsigned gost_rand_fork_gen;
+static pthread_once_t gost_rand_once = PTHREAD_ONCE_INIT;
+
+#ifndef _WIN32
+static void gost_rand_atfork_child(void) {
+    gost_rand_fork_gen++;
+}
+#endif
+
+static void gost_rand_register(void) {
+#ifndef _WIN32
+    pthread_atfork(NULL, NULL, gost_rand_atfork_child);
+#endif
+}
+
+int gost_rand_entropy(void *buf, size_t len) {
+    unsigned char *p = (unsigned char *)buf;
+
+#if defined(_WIN32)
+    while (len > 0) {
+        unsigned int v;
+        size_t n = len < sizeof(v) ? len : sizeof(v);
+        if (rand_s(&v) != 0)
+            return -1;
+        memcpy(p, &v, n);
+        p += n;
+        len -= n;
+    }
+#elif defined(__linux__)
+    while (len > 0) {
+        ssize_t n = getrandom(p, len, 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+#else
+    int fd = open("/dev/urandom", O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    close(fd);
+#endif
+    return 0;
+}
+
+#ifdef GOST_RAND_CHACHA20
+
+#define GOST_ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define GOST_QR(a, b, c, d) \
+    a += b; d ^= a; d = GOST_ROTL32(d, 16); \
+    c += d; b ^= c; b = GOST_ROTL32(b, 12); \
+    a += b; d ^= a; d = GOST_ROTL32(d, 8);  \
+    c += d; b ^= c; b = GOST_ROTL32(b, 7)
+
+/* Блок ChaCha20 (RFC 8439): 20 раундов над состоянием in, 64 байта выхода */
+static void gost_chacha20_block(unsigned char out[64], const uint32_t in[16]) {
+    uint32_t x[16];
+
+    memcpy(x, in, sizeof(x));
+    for (int i = 0; i < 10; i++) {
+        GOST_QR(x[0], x[4], x[8], x[12]);
+        GOST_QR(x[1], x[5], x[9], x[13]);
+        GOST_QR(x[2], x[6], x[10], x[14]);
+        GOST_QR(x[3], x[7], x[11], x[15]);
+        GOST_QR(x[0], x[5], x[10], x[15]);
+        GOST_QR(x[1], x[6], x[11], x[12]);
+        GOST_QR(x[2], x[7], x[8], x[13]);
+        GOST_QR(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        uint32_t v = x[i] + in[i];
+        out[4 * i] = (unsigned char)v;
+        out[4 * i + 1] = (unsigned char)(v >> 8);
+        out[4 * i + 2] = (unsigned char)(v >> 16);
+        out[4 * i + 3] = (unsigned char)(v >> 24);
+    }
+}
+
+/* len байт выхода на текущем ключе (счётчик блоков 0, 1, ..., нулевой nonce):
+   первые 32 байта блока 0 становятся следующим ключом, остальное — в out */
+static int gost_rand_fill(gost_rand_state_t *st, unsigned char *out, size_t len) {
+    uint32_t in[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    unsigned char block[64];
+    size_t n;
+
+    memcpy(in + 4, st->key, sizeof(st->key));
+    for (uint32_t b = 0;; b++) {
+        size_t off = 0;
+        in[12] = b;
+        gost_chacha20_block(block, in);
+        if (b == 0) {
+            for (int i = 0; i < 8; i++)
+                st->key[i] = (uint32_t)block[4 * i] | (uint32_t)block[4 * i + 1] << 8 |
+                             (uint32_t)block[4 * i + 2] << 16 | (uint32_t)block[4 * i + 3] << 24;
+            off = GOST_RAND_KEY_SIZE;
+        }
+        n = len < 64 - off ? len : 64 - off;
+        memcpy(out, block + off, n);
+        out += n;
+        len -= n;
+        if (len == 0)
+            break;
+    }
+    memset(block, 0, sizeof(block));
+    memset(in, 0, sizeof(in));
+    return 0;
+}
+
+/* Засев: новый ключ смешивается с текущим (xor), так что слабый системный
+   источник не ухудшает уже накопленное состояние */
+static int gost_rand_mix_seed(gost_rand_state_t *st) {
+    uint32_t seed[8];
+
+    if (gost_rand_entropy(seed, sizeof(seed)) != 0)
+        return -1;
+    for (int i = 0; i < 8; i++)
+        st->key[i] ^= seed[i];
+    memset(seed, 0, sizeof(seed));
+    return 0;
+}
+
+#else
+
+/* Первый засев: 32 байта энтропии и 16 байт nonce из системного источника,
+   персонализация — адрес состояния потока и поколение процесса, так что
+   потоки и процессы после fork получают разные строки даже при одинаковой энтропии */
+static int gost_rand_mix_seed(gost_rand_state_t *st) {
+    unsigned char seed[GOST_DRBG_ENTROPY_MIN + GOST_DRBG_ENTROPY_MIN / 2];
+    const void *self = st;
+    unsigned gen = gost_rand_fork_gen;
+    unsigned char pers[sizeof(self) + sizeof(gen)];
+    int ret;
+
+    if (gost_rand_entropy(seed, sizeof(seed)) != 0)
+        return -1;
+    memcpy(pers, &self, sizeof(self));
+    memcpy(pers + sizeof(self), &gen, sizeof(gen));
+    if (st->seeded)
+        ret = gost_drbg_reseed(&st->drbg, seed, GOST_DRBG_ENTROPY_MIN, pers, sizeof(pers));
+    else
+        ret = gost_drbg_instantiate(&st->drbg, seed, GOST_DRBG_ENTROPY_MIN,
+                                    seed + GOST_DRBG_ENTROPY_MIN, GOST_DRBG_ENTROPY_MIN / 2,
+                                    pers, sizeof(pers));
+    memset(seed, 0, sizeof(seed));
+    return ret;
+}
+
+/* len <= GOST_RAND_BULK байт одним запросом к DRBG; исчерпанный интервал
+   (при засеве каждые GOST_RAND_RESEED_BYTES не наступает) — внеочередной пересев */
+static int gost_rand_fill(gost_rand_state_t *st, unsigned char *out, size_t len) {
+    int ret = gost_drbg_generate(&st->drbg, out, len, NULL, 0);
+
+    if (ret == GOST_DRBG_NEED_RESEED) {
+        if (gost_rand_mix_seed(st) != 0)
+            return -1;
+        ret = gost_drbg_generate(&st->drbg, out, len, NULL, 0);
+    }
+    return ret == 0 ? 0 : -1;
+}
+
+#endif // GOST_RAND_CHACHA20
+
+/* Засев из системного источника; буфер сбрасывается и стирается */
+static int gost_rand_seed(gost_rand_state_t *st) {
+    if (gost_rand_mix_seed(st) != 0)
+        return -1;
+    memset(st->buf, 0, sizeof(st->buf));
+    st->pos = GOST_RAND_BUF_SIZE;
+    st->since_seed = 0;
+    st->fork_gen = gost_rand_fork_gen;
+    st->seeded = 1;
+    return 0;
+}
+
+int gost_rand_bytes(void *buf, size_t len) {
+    gost_rand_state_t *st = &gost_rand_tls;
+    unsigned char *out = (unsigned char *)buf;
+
+    if (!st->seeded)
+        pthread_once(&gost_rand_once, gost_rand_register);
+
+    while (len > 0) {
+        if (!st->seeded || st->fork_gen != gost_rand_fork_gen ||
+            st->since_seed >= GOST_RAND_RESEED_BYTES) {
+            if (gost_rand_seed(st) != 0)
+                return -1;
+        }
+        size_t n = GOST_RAND_BUF_SIZE - st->pos;
+        if (n == 0) {
+            if (len < GOST_RAND_BUF_SIZE) {
+                if (gost_rand_fill(st, st->buf, GOST_RAND_BUF_SIZE) != 0)
+                    return -1;
+                st->pos = 0;
+                continue;
+            }
+            // Большой запрос: выход сразу в out, без копирования через буфер
+            n = len < GOST_RAND_BULK ? len : GOST_RAND_BULK;
+            if (gost_rand_fill(st, out, n) != 0)
+                return -1;
+        } else {
+            if (n > len)
+                n = len;
+            memcpy(out, st->buf + st->pos, n);
+            memset(st->buf + st->pos, 0, n);
+            st->pos += n;
+        }
+        st->since_seed += n;
+        out += n;
+        len -= n;
+    }
+    return 0;
+}
+
+unsigned gost_rand_fork_generation(void) {
+    pthread_once(&gost_rand_once, gost_rand_register);
+    return gost_rand_fork_gen;
+}
+
+int gost_rand_scalar(mpz_t k, const mpz_t q) {
+    size_t bits = mpz_sizeinbase(q, 2), len = (bits + 7) / 8;
+    unsigned char buf[128];
+
+    if (len > sizeof(buf))
+        return -1;
+    do {
+        if (gost_rand_bytes(buf, len) != 0)
+            return -1;
+        if (bits % 8)
+            buf[0] &= (unsigned char)((1u << (bits % 8)) - 1);
+        mpz_import(k, len, 1, 1, 0, 0, buf);
+    } while (mpz_sgn(k) == 0 || mpz_cmp(k, q) >= 0);
+
+    memset(buf, 0, len);
+    return 0;
+}
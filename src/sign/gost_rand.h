@@ -0,0 +1,39 @@
+#ifndef GOST_RAND_H
+#define GOST_RAND_H
+
+#include <stddef.h>
+#include <gmp.h>
+
+/* Криптографический генератор случайных чисел для одноразовых чисел подписи
+   и ключей. У каждого потока своё состояние: HMAC_DRBG на Стрибоге-512
+   (gost_drbg.h) и буфер выхода из GOST_RAND_BLOCKS блоков по 64 байта.
+   Генератор засевается из системного источника (getrandom на Linux) при
+   первом обращении потока, после fork в дочернем процессе и после каждых
+   GOST_RAND_RESEED_BYTES выданных байт. Остальные обращения обходятся без
+   системных вызовов и блокировок; запрос длиннее буфера получает выход
+   напрямую, порциями до GOST_DRBG_MAX_REQUEST байт. Выданные байты
+   стираются из буфера, а DRBG обновляет K и V после каждого пополнения, так
+   что прошлые значения нельзя восстановить по текущему состоянию.
+   При сборке с -DGOST_RAND_CHACHA20 вместо DRBG используется ключ ChaCha20
+   (первые 32 байта каждого пополнения становятся новым ключом): примерно
+   в 50 раз быстрее, но не только на отечественных примитивах. */
+#define GOST_RAND_BLOCKS        16
+#define GOST_RAND_RESEED_BYTES  (1UL << 20)
+
+/* len байт из системного источника энтропии (без буферизации).
+   Возвращает 0 при успехе, -1 при ошибке. */
+int gost_rand_entropy(void *buf, size_t len);
+
+/* len случайных байт из генератора потока. Возвращает 0 при успехе,
+   -1, если системный источник недоступен. */
+int gost_rand_bytes(void *buf, size_t len);
+
+/* Поколение процесса: увеличивается в дочернем процессе после каждого fork.
+   Позволяет отбрасывать секретные значения, посчитанные до fork. */
+unsigned gost_rand_fork_generation(void);
+
+/* Равномерно распределённое k из [1, q-1] (выборка с отбрасыванием).
+   Возвращает 0 при успехе, -1, если системный источник недоступен. */
+int gost_rand_scalar(mpz_t k, const mpz_t q);
+
+#endif // GOST_RAND_H
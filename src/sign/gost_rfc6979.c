@@ -0,0 +1,92 @@
+#include "gost_rfc6979.h"
+#include <string.h>
+
+/* bits2int: строка байт как число, от которого оставлены старшие qbits бит */
+static void gost_rfc6979_bits2int(mpz_t z, const unsigned char *buf, size_t len, size_t qbits) {
+    mpz_import(z, len, 1, 1, 0, 0, buf);
+    if (8 * len > qbits)
+        mpz_tdiv_q_2exp(z, z, 8 * len - qbits);
+}
+
+/* int2octets: 0 <= x < 2^(8*rlen) в rlen байт, старший первым */
+static void gost_rfc6979_int2octets(unsigned char *out, size_t rlen, const mpz_t x) {
+    size_t n = mpz_sgn(x) ? (mpz_sizeinbase(x, 2) + 7) / 8 : 0;
+
+    memset(out, 0, rlen);
+    if (n)
+        mpz_export(out + rlen - n, NULL, 1, 1, 0, 0, x);
+}
+
+/* K = HMAC_K(V || sep || data), V = HMAC_K(V) */
+static void gost_rfc6979_update(gost_rfc6979_t *G, u8 sep, const unsigned char *data, size_t len) {
+    hmac_stribog_ctx_t H = G->K;
+    u8 K[GOST_RFC6979_MAX_HLEN];
+
+    hmac_stribog_update(&H, G->V, G->hlen);
+    hmac_stribog_update(&H, &sep, 1);
+    hmac_stribog_update(&H, data, len);
+    hmac_stribog_final(&H, K);
+    hmac_stribog_init(&G->K, G->size, K, G->hlen);
+    memset(K, 0, sizeof(K));
+
+    H = G->K;
+    hmac_stribog_update(&H, G->V, G->hlen);
+    hmac_stribog_final(&H, G->V);
+}
+
+void gost_rfc6979_init(gost_rfc6979_t *G, const mpz_t q, const mpz_t x,
+                       const unsigned char *h1, size_t h1_len, u8 size) {
+    unsigned char seed[2 * GOST_RFC6979_MAX_HLEN];
+    u8 K[GOST_RFC6979_MAX_HLEN] = {0};
+    size_t rlen;
+    mpz_t z;
+
+    G->size = size;
+    G->hlen = hmac_stribog_size(size);
+    G->qbits = mpz_sizeinbase(q, 2);
+    G->started = 0;
+    rlen = (G->qbits + 7) / 8;
+
+    // int2octets(x) || bits2octets(h1), где bits2octets(h1) = int2octets(bits2int(h1) mod q)
+    mpz_init(z);
+    gost_rfc6979_int2octets(seed, rlen, x);
+    gost_rfc6979_bits2int(z, h1, h1_len, G->qbits);
+    mpz_mod(z, z, q);
+    gost_rfc6979_int2octets(seed + rlen, rlen, z);
+    mpz_clear(z);
+
+    hmac_stribog_init(&G->K, size, K, G->hlen);
+    memset(G->V, 0x01, G->hlen);
+    gost_rfc6979_update(G, 0x00, seed, 2 * rlen);
+    gost_rfc6979_update(G, 0x01, seed, 2 * rlen);
+    memset(seed, 0, sizeof(seed));
+}
+
+void gost_rfc6979_next(gost_rfc6979_t *G, mpz_t k, const mpz_t q) {
+    unsigned char T[2 * GOST_RFC6979_MAX_HLEN];
+    size_t tlen;
+    hmac_stribog_ctx_t H;
+
+    // Продолжение после отвергнутого кандидата: K = HMAC_K(V || 0x00), V = HMAC_K(V)
+    if (G->started)
+        gost_rfc6979_update(G, 0x00, NULL, 0);
+    G->started = 1;
+
+    for (;;) {
+        for (tlen = 0; 8 * tlen < G->qbits; tlen += G->hlen) {
+            H = G->K;
+            hmac_stribog_update(&H, G->V, G->hlen);
+            hmac_stribog_final(&H, G->V);
+            memcpy(T + tlen, G->V, G->hlen);
+        }
+        gost_rfc6979_bits2int(k, T, tlen, G->qbits);
+        if (mpz_sgn(k) > 0 && mpz_cmp(k, q) < 0)
+            break;
+        gost_rfc6979_update(G, 0x00, NULL, 0);
+    }
+    memset(T, 0, sizeof(T));
+}
+
+void gost_rfc6979_clear(gost_rfc6979_t *G) {
+    memset(G, 0, sizeof(*G));
+}
@@ -0,0 +1,38 @@
+#ifndef GOST_RFC6979_H
+#define GOST_RFC6979_H
+
+#include <stddef.h>
+#include <gmp.h>
+#include "../hash/hmac_stribog.h"
+
+/* Детерминированные одноразовые числа по схеме RFC 6979 (разд. 3.2) с
+   HMAC-Стрибогом вместо HMAC-SHA: k зависит только от закрытого ключа x и
+   хэша сообщения h1, системный источник не используется. Длина HMAC равна
+   длине хэша подписи (256 бит для q < 2^256, иначе 512), так что на одного
+   кандидата обычно уходит один вызов HMAC. Кандидаты вне [1, q-1]
+   отбрасываются внутри генератора; если k не подошёл для подписи (r = 0 или
+   s = 0), следующий берётся продолжением той же последовательности. */
+
+#define GOST_RFC6979_MAX_HLEN   64
+
+typedef struct {
+    hmac_stribog_ctx_t K;           // HMAC с текущим ключом K
+    u8 V[GOST_RFC6979_MAX_HLEN];
+    u8 size;                        // HASH256 или HASH512
+    size_t hlen;                    // длина V в байтах
+    size_t qbits;
+    int started;                    // выдан хотя бы один кандидат
+} gost_rfc6979_t;
+
+/* Начальное состояние по x (0 < x < q) и хэшу h1 длиной h1_len байт
+   (число, старший байт первым). size — HASH256 или HASH512. */
+void gost_rfc6979_init(gost_rfc6979_t *G, const mpz_t q, const mpz_t x,
+                       const unsigned char *h1, size_t h1_len, u8 size);
+
+/* Следующий кандидат k из [1, q-1] */
+void gost_rfc6979_next(gost_rfc6979_t *G, mpz_t k, const mpz_t q);
+
+/* Стирание состояния */
+void gost_rfc6979_clear(gost_rfc6979_t *G);
+
+#endif // GOST_RFC6979_H
@@ -0,0 +1,23 @@
+#include "gost_workspace.h"
+
+/* Лимб сверху: mpz_import и fp_to_mpz пишут не больше FP_MAX_LIMBS лимбов */
+#define GOST_WORKSPACE_BITS (FP_MAX_BITS + GMP_NUMB_BITS)
+
+void gost_workspace_init(gost_workspace_t *W) {
+    mpz_init2(W->k, GOST_WORKSPACE_BITS);
+    mpz_init2(W->z1, GOST_WORKSPACE_BITS);
+    mpz_init2(W->z2, GOST_WORKSPACE_BITS);
+    ec_point_init2(&W->R, GOST_WORKSPACE_BITS);
+}
+
+/* Лимбов выделено больше FP_MAX_LIMBS, так что mpz_limbs_write не перевыделяет память */
+void gost_workspace_wipe(gost_workspace_t *W) {
+    mpn_zero(mpz_limbs_write(W->k, FP_MAX_LIMBS), FP_MAX_LIMBS);
+    mpz_limbs_finish(W->k, 0);
+}
+
+void gost_workspace_clear(gost_workspace_t *W) {
+    gost_workspace_wipe(W);
+    mpz_clears(W->k, W->z1, W->z2, NULL);
+    ec_point_clear(&W->R);
+}
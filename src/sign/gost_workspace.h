@@ -0,0 +1,28 @@
+#ifndef GOST_WORKSPACE_H
+#define GOST_WORKSPACE_H
+
+#include <gmp.h>
+#include "../ec/ec_point.h"
+
+/* Рабочая область подписи и проверки (gost3410_sign_curve_ws,
+   gost3410_verify_curve_ws): временные mpz_t и точка выделяются один раз
+   с запасом на FP_MAX_BITS, так что при повторных вызовах на встроенной
+   кривой память из кучи не запрашивается. Остальные временные значения —
+   на лимбах фиксированной длины в стеке. Одна область — на один поток:
+   одновременно использовать её из нескольких потоков нельзя. */
+typedef struct {
+    mpz_t k;                        // одноразовое число
+    mpz_t z1, z2;                   // множители проверки z1 = s/e, z2 = -r/e
+    EC_Point R;                     // k*P или z1*P + z2*Q
+} gost_workspace_t;
+
+/* Выделение памяти рабочей области */
+void gost_workspace_init(gost_workspace_t *W);
+
+/* Стирание одноразового числа (после каждой подписи) */
+void gost_workspace_wipe(gost_workspace_t *W);
+
+/* Стирание одноразового числа и освобождение рабочей области */
+void gost_workspace_clear(gost_workspace_t *W);
+
+#endif // GOST_WORKSPACE_H
@@ -0,0 +1,231 @@
+/* Замеры скорости скалярного умножения на встроенных кривых.
+ *
+ * Для каждой кривой сравниваются обычное умножение (с ветвлениями по битам
+ * скаляра, используется для открытых скаляров при проверке подписи) и
+ * умножение за постоянное время для секретных скаляров, с таблицей
+ * фиксированной базы и без неё, а также способы обращения по модулям p и q:
+ * safegcd, малая теорема Ферма, mpz_invert и mpn_sec_invert из GMP. В конце —
+ * задержка одной проверки подписи (p50/p99) в одном потоке и с разделением
+ * z1*P и z2*Q с помощником (gost3410_verify_curve_split). Собирается так же, как gen_tables (команды
+ * сборки — в README), и запускается как
+ *   ./bench [число повторов]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <gmp.h>
+#include "../src/ec/fp_safegcd.h"
+#include "../src/sign/gost_curve.h"
+#include "../src/sign/gost_params.h"
+#include "../src/sign/gost3410.h"
+
+#define BENCH_KEYS 16
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef enum { BENCH_MUL, BENCH_MUL_CT, BENCH_TABLE, BENCH_TABLE_CT } bench_kind_t;
+
+/* Среднее время одного умножения в микросекундах */
+static double bench_mul(const gost_curve_t *C, bench_kind_t kind, mpz_t k[], int iters) {
+    const ec_ctx_t *E = &C->T.E;
+    size_t bits = mpz_sizeinbase(C->q, 2);
+    ec_jpoint_t R;
+    double t = bench_now();
+
+    for (int i = 0; i < iters; i++) {
+        const mpz_t *ki = &k[i % BENCH_KEYS];
+        switch (kind) {
+        case BENCH_MUL:
+            ec_jpoint_mul(E, &R, *ki, &C->T.P);
+            break;
+        case BENCH_MUL_CT:
+            ec_jpoint_mul_ct(E, &R, *ki, &C->T.P, bits);
+            break;
+        case BENCH_TABLE:
+            ec_jpoint_mul_table(&C->T, &R, *ki);
+            break;
+        case BENCH_TABLE_CT:
+            ec_jpoint_mul_table_ct(&C->T, &R, *ki);
+            break;
+        }
+    }
+    return (bench_now() - t) * 1e6 / iters;
+}
+
+typedef enum { BENCH_INV_SAFEGCD, BENCH_INV_FERMAT, BENCH_INV_MPZ, BENCH_INV_SEC } bench_inv_t;
+
+/* Среднее время одного обращения по модулю m в микросекундах */
+static double bench_inv(const mpz_t m, bench_inv_t kind, mpz_t k[], int iters) {
+    mp_size_t n = (mp_size_t)mpz_size(m);
+    mp_limb_t a[FP_MAX_LIMBS], r[FP_MAX_LIMBS], *tp;
+    fp_ctx_t F;
+    fp_t x[BENCH_KEYS], y;
+    mpz_t v;
+    double t;
+
+    fp_ctx_init(&F, m);
+    for (int i = 0; i < BENCH_KEYS; i++)
+        fp_from_mpz(&F, &x[i], k[i]);
+    tp = (mp_limb_t *)malloc((size_t)mpn_sec_invert_itch(n) * sizeof(mp_limb_t));
+    mpz_init(v);
+
+    t = bench_now();
+    for (int i = 0; i < iters; i++) {
+        int j = i % BENCH_KEYS;
+        switch (kind) {
+        case BENCH_INV_SAFEGCD:
+            fp_inv(&F, &y, &x[j]);
+            break;
+        case BENCH_INV_FERMAT:
+            fp_inv_fermat(&F, &y, &x[j]);
+            break;
+        case BENCH_INV_MPZ:
+            mpz_invert(v, k[j], m);
+            break;
+        case BENCH_INV_SEC:
+            mpn_zero(a, n);
+            mpn_copyi(a, mpz_limbs_read(k[j]), (mp_size_t)mpz_size(k[j]));
+            mpn_sec_invert(r, a, mpz_limbs_read(m), n, 2 * (mp_bitcnt_t)n * GMP_NUMB_BITS, tp);
+            break;
+        }
+    }
+    t = (bench_now() - t) * 1e6 / iters;
+
+    mpz_clear(v);
+    free(tp);
+    return t;
+}
+
+/* Строка таблицы обращений по модулю m */
+static void bench_inv_row(const char *name, const mpz_t m, gmp_randstate_t rs, mpz_t k[], int iters) {
+    for (int i = 0; i < BENCH_KEYS; i++)
+        mpz_urandomm(k[i], rs, m);
+    printf("%-44s %10.2f %10.2f %10.2f %10.2f\n", name, bench_inv(m, BENCH_INV_SAFEGCD, k, iters),
+           bench_inv(m, BENCH_INV_FERMAT, k, iters), bench_inv(m, BENCH_INV_MPZ, k, iters),
+           bench_inv(m, BENCH_INV_SEC, k, iters));
+}
+
+static int bench_cmp(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Задержки iters проверок подписи в микросекундах, по возрастанию;
+   при H == NULL — в одном потоке */
+static void bench_verify(const gost_curve_t *C, const EC_Point *Q, const ec_table_t *TQ,
+                         const unsigned char *msg, size_t len, const mpz_t r, const mpz_t s,
+                         gost_helper_pool_t *H, double lat[], int iters) {
+    for (int i = 0; i < iters; i++) {
+        double t = bench_now();
+        if (TQ)
+            H ? gost3410_verify_curve_key_split(msg, len, r, s, TQ, C, H)
+              : gost3410_verify_curve_key(msg, len, r, s, TQ, C);
+        else
+            H ? gost3410_verify_curve_split(msg, len, r, s, Q, C, H)
+              : gost3410_verify_curve(msg, len, r, s, Q, C);
+        lat[i] = (bench_now() - t) * 1e6;
+    }
+    qsort(lat, (size_t)iters, sizeof(double), bench_cmp);
+}
+
+/* Строка таблицы задержек: p50 и p99 в одном потоке и с разделением */
+static void bench_verify_row(const char *name, const gost_curve_t *C, const EC_Point *Q,
+                             const ec_table_t *TQ, const mpz_t r, const mpz_t s,
+                             gost_helper_pool_t *H, double lat[], int iters) {
+    static const unsigned char msg[] = "bench";
+    double p50, p99;
+
+    bench_verify(C, Q, TQ, msg, sizeof(msg) - 1, r, s, NULL, lat, iters);
+    p50 = lat[iters / 2];
+    p99 = lat[iters * 99 / 100];
+    bench_verify(C, Q, TQ, msg, sizeof(msg) - 1, r, s, H, lat, iters);
+    printf("%-44s %10.1f %10.1f %10.1f %10.1f\n", name, p50, p99, lat[iters / 2], lat[iters * 99 / 100]);
+}
+
+int main(int argc, char *argv[]) {
+    int iters = argc > 1 ? atoi(argv[1]) : 200;
+    gmp_randstate_t rs;
+    mpz_t k[BENCH_KEYS];
+
+    if (iters <= 0)
+        iters = 200;
+    gmp_randinit_default(rs);
+    for (int i = 0; i < BENCH_KEYS; i++)
+        mpz_init(k[i]);
+
+    printf("%-42s %10s %10s %6s %10s %10s %6s\n", "curve (us per k*P)", "mul", "mul_ct", "ratio",
+           "table", "table_ct", "ratio");
+    for (size_t c = 0; c < gost_paramsets_count; c++) {
+        const gost_curve_t *C = gost_curve_get(gost_paramsets[c].name);
+        double mul, mul_ct, tab, tab_ct;
+
+        if (!C) {
+            fprintf(stderr, "Error: cannot build curve %s\n", gost_paramsets[c].name);
+            return EXIT_FAILURE;
+        }
+        for (int i = 0; i < BENCH_KEYS; i++)
+            mpz_urandomm(k[i], rs, C->q);
+
+        mul = bench_mul(C, BENCH_MUL, k, iters);
+        mul_ct = bench_mul(C, BENCH_MUL_CT, k, iters);
+        tab = bench_mul(C, BENCH_TABLE, k, iters);
+        tab_ct = bench_mul(C, BENCH_TABLE_CT, k, iters);
+        printf("%-42s %10.1f %10.1f %6.2f %10.1f %10.1f %6.2f\n", C->name, mul, mul_ct, mul_ct / mul,
+               tab, tab_ct, tab_ct / tab);
+    }
+
+    printf("\n%-44s %10s %10s %10s %10s\n", "inversion (us)", "safegcd", "fermat", "mpz", "sec");
+    for (size_t c = 0; c < gost_paramsets_count; c++) {
+        const gost_curve_t *C = gost_curve_get(gost_paramsets[c].name);
+        char name[64];
+
+        snprintf(name, sizeof(name), "%.38s mod p", C->name);
+        bench_inv_row(name, C->p, rs, k, iters);
+        snprintf(name, sizeof(name), "%.38s mod q", C->name);
+        bench_inv_row(name, C->q, rs, k, iters);
+    }
+
+    gost_helper_pool_t H;
+    double *lat = (double *)malloc((size_t)iters * sizeof(double));
+    if (!lat || gost_helper_pool_init(&H, 1, NULL) != 0) {
+        fprintf(stderr, "Error: cannot start helper thread\n");
+        return EXIT_FAILURE;
+    }
+    printf("\n%-44s %10s %10s %10s %10s\n", "verify latency (us)", "p50", "p99", "split p50", "split p99");
+    for (size_t c = 0; c < gost_paramsets_count; c++) {
+        const gost_curve_t *C = gost_curve_get(gost_paramsets[c].name);
+        static const unsigned char msg[] = "bench";
+        ec_table_t TQ;
+        EC_Point Q;
+        mpz_t r, s;
+        char name[64];
+
+        ec_point_init(&Q);
+        mpz_inits(r, s, NULL);
+        if (gost3410_keygen(k[0], &Q, C) != 0) {
+            fprintf(stderr, "Error: no entropy for key generation\n");
+            return EXIT_FAILURE;
+        }
+        gost3410_sign_curve(r, s, msg, sizeof(msg) - 1, k[0], C);
+        ec_table_init(&TQ, &Q, C->p, C->a, mpz_sizeinbase(C->q, 2));
+
+        bench_verify_row(C->name, C, &Q, NULL, r, s, &H, lat, iters);
+        snprintf(name, sizeof(name), "%.34s key table", C->name);
+        bench_verify_row(name, C, &Q, &TQ, r, s, &H, lat, iters);
+
+        ec_table_clear(&TQ);
+        ec_point_clear(&Q);
+        mpz_clears(r, s, NULL);
+    }
+    gost_helper_pool_clear(&H);
+    free(lat);
+
+    for (int i = 0; i < BENCH_KEYS; i++)
+        mpz_clear(k[i]);
+    gmp_randclear(rs);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* Генератор встроенных таблиц фиксированной базы для стандартных кривых.
+ *
+ * Строит таблицы для всех наборов из gost_params.c и печатает их в виде
+ * static const массивов лимбов во внутреннем представлении поля. Результат
+ * подключается в gost_curve.c при сборке с -DGOST_BAKED_TABLES, после чего
+ * gost_curve_get не строит таблицы при старте, а точки лежат в секции
+ * только для чтения, общей для всех процессов с этим исполняемым файлом.
+ *
+ * Генератор собирается из тех же исходников, но без -DGOST_BAKED_TABLES
+ * (команды сборки — в README), и запускается как
+ *   ./gen_tables src/sign/gost_baked_tables.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "../src/sign/gost_curve.h"
+#include "../src/sign/gost_params.h"
+
+static void print_fp(FILE *out, const fp_ctx_t *F, const fp_t *a) {
+    fprintf(out, "{{");
+    for (mp_size_t i = 0; i < F->n; i++)
+        fprintf(out, "%s0x%llxULL", i ? "," : "", (unsigned long long)a->v[i]);
+    fprintf(out, "}}");
+}
+
+static int print_table(FILE *out, size_t idx, const gost_curve_t *C) {
+    const ec_table_t *T = &C->T;
+    size_t count = T->nwin * EC_TABLE_ENTRIES;
+
+    fprintf(out, "\n// %s\n", C->name);
+    fprintf(out, "static const ec_apoint_t gost_baked_%zu[%zu] = {\n", idx, count);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(out, "    {");
+        print_fp(out, &T->E.F, &T->pts[i].x);
+        fprintf(out, ", ");
+        print_fp(out, &T->E.F, &T->pts[i].y);
+        fprintf(out, ", %d},\n", T->pts[i].infinity);
+    }
+    fprintf(out, "};\n");
+    return ferror(out) ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    FILE *out = stdout;
+    gost_curve_t C;
+
+    if (argc > 1 && !(out = fopen(argv[1], "w"))) {
+        perror("Error opening output file");
+        return EXIT_FAILURE;
+    }
+
+    fprintf(out, "/* Сгенерировано tools/gen_tables.c — не редактировать вручную */\n");
+    fprintf(out, "#ifndef GOST_BAKED_TABLES_H\n#define GOST_BAKED_TABLES_H\n\n");
+    // Представление элементов зависит от размера лимба и ширины окна генератора
+    fprintf(out, "#if GMP_NUMB_BITS != %d || EC_TABLE_W != %d || EC_TABLE_FORMAT != %d\n", GMP_NUMB_BITS,
+            EC_TABLE_W, EC_TABLE_FORMAT);
+    fprintf(out, "#error \"gost_baked_tables.h was generated for another limb size or table layout\"\n");
+    fprintf(out, "#endif\n");
+
+    for (size_t i = 0; i < gost_paramsets_count; i++) {
+        if (gost_curve_init_params(&C, &gost_paramsets[i]) != 0) {
+            fprintf(stderr, "Error: cannot build table for %s\n", gost_paramsets[i].name);
+            return EXIT_FAILURE;
+        }
+        if (print_table(out, i, &C) != 0) {
+            fprintf(stderr, "Error writing output\n");
+            return EXIT_FAILURE;
+        }
+        gost_curve_clear(&C);
+    }
+
+    fprintf(out, "\nstatic const struct {\n    const char *oid;\n    const ec_apoint_t *pts;\n    size_t count;\n} gost_baked_tables[] = {\n");
+    for (size_t i = 0; i < gost_paramsets_count; i++)
+        fprintf(out, "    {\"%s\", gost_baked_%zu, sizeof(gost_baked_%zu) / sizeof(ec_apoint_t)},\n",
+                gost_paramsets[i].oid, i, i);
+    fprintf(out, "};\n\n#endif // GOST_BAKED_TABLES_H\n");
+
+    if (out != stdout && fclose(out) != 0) {
+        perror("Error closing output file");
+        return EXIT_FAILURE;
+    }
+    return 0;
+}